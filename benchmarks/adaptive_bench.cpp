@@ -0,0 +1,110 @@
+// Adaptive lookup path selection under shifting hit/miss mixes.
+//
+// Compares EnumString::try_to_enum with AdaptiveEnumString::try_to_enum on
+// streams with 0% to 95% misses (unknown strings of the same shape as the
+// mapped ones), reporting ns/op, the overhead of the wrapper and the mode it
+// settled in. A final phase run flips between hit-only and miss-heavy traffic
+// to show the mode following it.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/adaptive_bench.cpp -o adaptive_bench
+// Usage: adaptive_bench [--quick]
+
+#include <cstring>
+#include <memory>
+
+#include <Topname/AdaptiveLookup.hpp>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t N = 256;
+constexpr std::size_t INPUTS = 4096;
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+const char* mode_name(AdaptiveMode mode) {
+    return mode == AdaptiveMode::DirectProbe ? "direct" : "prefilter";
+}
+
+std::vector<std::string_view> make_stream(const std::vector<std::string>& keys, const std::vector<std::string>& unknown,
+                                          double miss_share, std::mt19937_64& rng) {
+    std::bernoulli_distribution miss(miss_share);
+    std::uniform_int_distribution<std::size_t> pick(0, N - 1);
+    std::vector<std::string_view> stream(INPUTS);
+    for (auto& value : stream) {
+        value = miss(rng) ? unknown[pick(rng)] : keys[pick(rng)];
+    }
+    return stream;
+}
+
+/**
+ * @brief Times try_to_enum over a stream, in a function of its own per table type
+ *        so that both variants get the same inlining budget.
+ */
+template<typename Table>
+Result time_stream(const Table& table, const std::vector<std::string_view>& stream) {
+    return measure(INPUTS, [&](std::size_t i) { do_not_optimize(table.try_to_enum(stream[i])); }, g_min_time);
+}
+
+void run_shape(KeyShape shape, std::mt19937_64& rng) {
+    std::vector<std::string> keys = make_keys(shape, 2 * N, rng);
+    std::vector<std::string> unknown(keys.begin() + N, keys.end());
+    keys.resize(N);
+    auto table = std::make_unique<EnumString<Key, N>>(make_table<N>(keys));
+    std::string_view engine = engine_name(table->engine());
+
+    for (double miss_share : {0.0, 0.05, 0.5, 0.95}) {
+        std::vector<std::string_view> stream = make_stream(keys, unknown, miss_share, rng);
+        auto adaptive = std::make_unique<AdaptiveEnumString<Key, N>>(*table);
+        Result direct = time_stream(*table, stream);
+        Result adapted = time_stream(*adaptive, stream);
+        AdaptiveStats s = adaptive->stats();
+        std::printf("%-7s %-22.*s %6.0f%% %10.2f %10.2f %+9.1f%% %-10s %8.0f%%\n", shape_name(shape),
+                    static_cast<int>(engine.size()), engine.data(), miss_share * 100, direct.ns_per_op,
+                    adapted.ns_per_op, (adapted.ns_per_op / direct.ns_per_op - 1.0) * 100,
+                    mode_name(s.mode), s.rejected_rate * 100);
+    }
+}
+
+void run_phases(std::mt19937_64& rng) {
+    std::vector<std::string> keys = make_keys(KeyShape::Long, 2 * N, rng);
+    std::vector<std::string> unknown(keys.begin() + N, keys.end());
+    keys.resize(N);
+    auto table = std::make_unique<EnumString<Key, N>>(make_table<N>(keys));
+    AdaptiveEnumString<Key, N> adaptive(*table);
+
+    std::printf("\nphase   misses  mode after  switches\n");
+    const double phases[] = {0.0, 0.9, 0.9, 0.2, 0.0, 0.9};
+    for (std::size_t p = 0; p < std::size(phases); p++) {
+        std::vector<std::string_view> stream = make_stream(keys, unknown, phases[p], rng);
+        for (std::size_t round = 0; round < 64; round++) {
+            for (std::string_view value : stream) {
+                do_not_optimize(adaptive.try_to_enum(value));
+            }
+        }
+        AdaptiveStats s = adaptive.stats();
+        std::printf("%5zu %7.0f%%  %-10s %9llu\n", p, phases[p] * 100, mode_name(s.mode),
+                    static_cast<unsigned long long>(s.switches));
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::strcmp(argv[1], "--quick") == 0) {
+        g_min_time = std::chrono::milliseconds(2);
+    }
+
+    std::mt19937_64 rng(17);
+    std::printf("%-7s %-22s %7s %10s %10s %10s %-10s %9s\n", "keys", "engine", "misses", "direct",
+                "adaptive", "overhead", "mode", "rejected");
+    for (KeyShape shape : ALL_SHAPES) {
+        run_shape(shape, rng);
+    }
+    run_phases(rng);
+    return 0;
+}
@@ -0,0 +1,218 @@
+#ifndef TOPNAME_BENCH_COMMON_H
+#define TOPNAME_BENCH_COMMON_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <Topname/Topname.hpp>
+
+namespace Topname::bench {
+
+/**
+ * @brief Keeps the compiler from discarding a computed value.
+ */
+template<typename T>
+inline void do_not_optimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* sink;
+    sink = &value;
+#endif
+}
+
+/**
+ * @brief An enum able to hold any generated key index.
+ */
+enum class Key : uint32_t {};
+
+enum class KeyShape { Short, Long, SharedPrefix };
+enum class Distribution { Uniform, Zipf };
+
+inline constexpr std::array<KeyShape, 3> ALL_SHAPES{KeyShape::Short, KeyShape::Long, KeyShape::SharedPrefix};
+inline constexpr std::array<Distribution, 2> ALL_DISTRIBUTIONS{Distribution::Uniform, Distribution::Zipf};
+
+inline const char* shape_name(KeyShape shape) {
+    switch (shape) {
+        case KeyShape::Short: return "short";
+        case KeyShape::Long: return "long";
+        case KeyShape::SharedPrefix: return "prefix";
+    }
+    return "?";
+}
+
+inline const char* distribution_name(Distribution dist) {
+    return dist == Distribution::Uniform ? "uniform" : "zipf";
+}
+
+/**
+ * @brief Generates count distinct keys of the given shape.
+ *
+ * Short keys are 4-8 characters, long keys 32-64, shared-prefix keys are a
+ * 22-character common prefix followed by a short suffix.
+ */
+inline std::vector<std::string> make_keys(KeyShape shape, std::size_t count, std::mt19937_64& rng) {
+    static constexpr std::string_view alphabet = "ABCDEFGHIJKLMNOPQRSTUVWXYZ_0123456789";
+    std::uniform_int_distribution<std::size_t> pick(0, alphabet.size() - 1);
+    auto random_string = [&](std::size_t min_len, std::size_t max_len) {
+        std::uniform_int_distribution<std::size_t> len(min_len, max_len);
+        std::string str(len(rng), ' ');
+        for (char& ch : str) {
+            ch = alphabet[pick(rng)];
+        }
+        return str;
+    };
+
+    std::unordered_set<std::string> seen;
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    while (keys.size() < count) {
+        std::string key;
+        switch (shape) {
+            case KeyShape::Short: key = random_string(4, 8); break;
+            case KeyShape::Long: key = random_string(32, 64); break;
+            case KeyShape::SharedPrefix: key = "ERROR_NETWORK_TIMEOUT_" + random_string(2, 8); break;
+        }
+        if (seen.insert(key).second) {
+            keys.push_back(std::move(key));
+        }
+    }
+    return keys;
+}
+
+/**
+ * @brief Draws count indices in [0, n) from the given distribution.
+ *
+ * Zipf uses exponent 1: index k is drawn with probability proportional to 1/(k+1).
+ */
+inline std::vector<uint32_t> make_indices(Distribution dist, std::size_t n, std::size_t count, std::mt19937_64& rng) {
+    std::vector<uint32_t> out(count);
+    if (dist == Distribution::Uniform) {
+        std::uniform_int_distribution<uint32_t> pick(0, static_cast<uint32_t>(n - 1));
+        for (auto& idx : out) {
+            idx = pick(rng);
+        }
+        return out;
+    }
+    std::vector<double> weights(n);
+    for (std::size_t k = 0; k < n; k++) {
+        weights[k] = 1.0 / static_cast<double>(k + 1);
+    }
+    std::discrete_distribution<uint32_t> pick(weights.begin(), weights.end());
+    // Shuffle ranks so the hot keys are not simply the first declared ones.
+    std::vector<uint32_t> permutation(n);
+    for (std::size_t k = 0; k < n; k++) {
+        permutation[k] = static_cast<uint32_t>(k);
+    }
+    std::shuffle(permutation.begin(), permutation.end(), rng);
+    for (auto& idx : out) {
+        idx = permutation[pick(rng)];
+    }
+    return out;
+}
+
+/**
+ * @brief Flips the case of random letters, for case-insensitive lookups.
+ */
+inline std::string scramble_case(std::string str, std::mt19937_64& rng) {
+    for (char& ch : str) {
+        if (rng() & 1) {
+            ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+        }
+    }
+    return str;
+}
+
+/**
+ * @brief Builds an EnumString<Key, N> whose i-th mapping is (Key(i), keys[i]).
+ */
+template<std::size_t N>
+EnumString<Key, N> make_table(const std::vector<std::string>& keys) {
+    std::array<std::pair<Key, std::string_view>, N> pairs;
+    for (std::size_t i = 0; i < N; i++) {
+        pairs[i] = {static_cast<Key>(i), keys[i]};
+    }
+    return EnumString<Key, N>::from_pairs(pairs);
+}
+
+struct Result {
+    double ns_per_op;
+    double p50;
+    double p99;
+};
+
+/**
+ * @brief Times op(i) over a sequence of inputs.
+ *
+ * Runs batches of BATCH operations until at least min_time has elapsed. The
+ * mean over all batches gives ns/op; per-batch means give the percentiles,
+ * which keeps clock overhead out of the latency figures.
+ *
+ * @param inputs Number of distinct inputs; op receives indices in [0, inputs).
+ * @param op Callable performing one operation on input i.
+ */
+template<typename Op>
+Result measure(std::size_t inputs, Op&& op, std::chrono::nanoseconds min_time = std::chrono::milliseconds(20)) {
+    using clock = std::chrono::steady_clock;
+    constexpr std::size_t BATCH = 32;
+
+    for (std::size_t i = 0; i < std::min<std::size_t>(inputs, 1024); i++) {
+        op(i); // Warm up caches and branch predictors.
+    }
+
+    std::vector<double> samples;
+    std::size_t cursor = 0;
+    std::size_t total_ops = 0;
+    clock::duration total{};
+    while (total < min_time || samples.size() < 100) {
+        auto start = clock::now();
+        for (std::size_t i = 0; i < BATCH; i++) {
+            op(cursor);
+            if (++cursor == inputs) {
+                cursor = 0;
+            }
+        }
+        auto elapsed = clock::now() - start;
+        total += elapsed;
+        total_ops += BATCH;
+        samples.push_back(std::chrono::duration<double, std::nano>(elapsed).count() / BATCH);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto percentile = [&samples](double p) {
+        return samples[std::min(samples.size() - 1, static_cast<std::size_t>(p * samples.size()))];
+    };
+    return {std::chrono::duration<double, std::nano>(total).count() / static_cast<double>(total_ops),
+            percentile(0.50), percentile(0.99)};
+}
+
+/**
+ * @brief Prints the header of the result table.
+ */
+inline void print_header() {
+    std::printf("%-22s %-7s %-8s %6s %10s %10s %10s\n",
+                "operation", "keys", "dist", "N", "ns/op", "p50", "p99");
+}
+
+/**
+ * @brief Prints one row of the result table.
+ */
+inline void print_row(std::string_view op, KeyShape shape, Distribution dist, std::size_t n, const Result& r) {
+    std::printf("%-22.*s %-7s %-8s %6zu %10.2f %10.2f %10.2f\n",
+                static_cast<int>(op.size()), op.data(), shape_name(shape), distribution_name(dist),
+                n, r.ns_per_op, r.p50, r.p99);
+}
+
+} // namespace Topname::bench
+
+#endif // TOPNAME_BENCH_COMMON_H
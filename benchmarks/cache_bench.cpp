@@ -0,0 +1,107 @@
+// Per-thread lookup cache under skewed traffic.
+//
+// Compares EnumString with CachedEnumString (default 8 slots and 64 slots) on
+// to_enum and to_enum_insensitive for uniform and Zipf inputs. Inputs either
+// point into the key storage, so the same buffer repeats, or are copied into a
+// scratch buffer before every lookup, like values parsed out of a request.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/cache_bench.cpp -o cache_bench
+// Usage: cache_bench [--quick]
+
+#include <cstring>
+#include <memory>
+
+#include <Topname/LookupCache.hpp>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t INPUTS = 4096;
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+enum class Source { SameBuffer, Copied };
+
+const char* source_name(Source source) {
+    return source == Source::SameBuffer ? "same" : "copied";
+}
+
+/**
+ * @brief Times one lookup kind over the inputs, copying each input first for Source::Copied.
+ */
+template<typename Table>
+Result time_lookups(const Table& table, const std::vector<std::string_view>& inputs, Source source, bool insensitive) {
+    std::string scratch;
+    scratch.reserve(256);
+    auto input = [&](std::size_t i) -> std::string_view {
+        if (source == Source::SameBuffer) {
+            return inputs[i];
+        }
+        scratch.assign(inputs[i]);
+        return scratch;
+    };
+    if (insensitive) {
+        return measure(INPUTS, [&](std::size_t i) { do_not_optimize(table.to_enum_insensitive(input(i))); }, g_min_time);
+    }
+    return measure(INPUTS, [&](std::size_t i) { do_not_optimize(table.to_enum(input(i))); }, g_min_time);
+}
+
+template<std::size_t N>
+void run_size(KeyShape shape, Distribution dist, std::mt19937_64& rng) {
+    std::vector<std::string> keys = make_keys(shape, N, rng);
+    auto table = std::make_unique<EnumString<Key, N>>(make_table<N>(keys));
+    auto cached = std::make_unique<CachedEnumString<Key, N>>(*table);
+    auto large = std::make_unique<CachedEnumString<Key, N, NoInstrumentation, 64>>(*table);
+
+    std::vector<uint32_t> indices = make_indices(dist, N, INPUTS, rng);
+    // One spelling per key: clients repeat their own spelling rather than inventing a new one per request.
+    std::vector<std::string> scrambled(N);
+    for (std::size_t k = 0; k < N; k++) {
+        scrambled[k] = scramble_case(keys[k], rng);
+    }
+    std::vector<std::string_view> exact(INPUTS);
+    std::vector<std::string_view> mixed_case(INPUTS);
+    for (std::size_t i = 0; i < INPUTS; i++) {
+        exact[i] = keys[indices[i]];
+        mixed_case[i] = scrambled[indices[i]];
+    }
+
+    for (bool insensitive : {false, true}) {
+        const auto& inputs = insensitive ? mixed_case : exact;
+        for (Source source : {Source::SameBuffer, Source::Copied}) {
+            Result direct = time_lookups(*table, inputs, source, insensitive);
+            Result small = time_lookups(*cached, inputs, source, insensitive);
+            Result big = time_lookups(*large, inputs, source, insensitive);
+            std::printf("%-20s %-7s %-8s %-7s %6zu %10.2f %10.2f %10.2f %+9.1f%%\n",
+                        insensitive ? "to_enum_insensitive" : "to_enum", shape_name(shape),
+                        distribution_name(dist), source_name(source), N, direct.ns_per_op, small.ns_per_op,
+                        big.ns_per_op, (small.ns_per_op / direct.ns_per_op - 1.0) * 100);
+        }
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    if (quick) {
+        g_min_time = std::chrono::milliseconds(2);
+    }
+
+    std::mt19937_64 rng(23);
+    std::printf("%-20s %-7s %-8s %-7s %6s %10s %10s %10s %10s\n", "operation", "keys", "dist", "input", "N",
+                "direct", "8 slots", "64 slots", "8 vs dir");
+    for (KeyShape shape : ALL_SHAPES) {
+        for (Distribution dist : ALL_DISTRIBUTIONS) {
+            run_size<64>(shape, dist, rng);
+            if (!quick) {
+                run_size<1024>(shape, dist, rng);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,272 @@
+// Compares EnumString with what engineers would otherwise write.
+//
+// The same 16 HTTP method names are resolved by EnumString, std::unordered_map,
+// std::map, a sorted std::array searched with std::lower_bound, an if/else
+// chain and a switch on the length. For each implementation the benchmark
+// reports throughput on identical inputs, the size of the lookup function
+// (read from this executable's symbol table, out-of-line callees excluded)
+// and the size of the table including its heap allocations.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/compare_bench.cpp -o compare_bench
+// Usage: compare_bench [--quick]
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <new>
+#include <unordered_map>
+
+#include "bench_common.hpp"
+#include "elf_sizes.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+// Heap accounting, so node-based containers report their real footprint.
+static std::size_t g_allocated = 0;
+
+void* operator new(std::size_t size) {
+    g_allocated += size;
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+enum class Method : int {
+    GET, HEAD, POST, PUT, DELETE, CONNECT, OPTIONS, TRACE,
+    PATCH, PROPFIND, PROPPATCH, MKCOL, COPY, MOVE, LOCK, UNLOCK
+};
+
+constexpr std::array<std::string_view, 16> METHOD_NAMES{
+    "GET", "HEAD", "POST", "PUT", "DELETE", "CONNECT", "OPTIONS", "TRACE",
+    "PATCH", "PROPFIND", "PROPPATCH", "MKCOL", "COPY", "MOVE", "LOCK", "UNLOCK"
+};
+
+constexpr auto methods = EnumString(
+    Method::GET,      "GET",
+    Method::HEAD,     "HEAD",
+    Method::POST,     "POST",
+    Method::PUT,      "PUT",
+    Method::DELETE,   "DELETE",
+    Method::CONNECT,  "CONNECT",
+    Method::OPTIONS,  "OPTIONS",
+    Method::TRACE,    "TRACE",
+    Method::PATCH,    "PATCH",
+    Method::PROPFIND, "PROPFIND",
+    Method::PROPPATCH,"PROPPATCH",
+    Method::MKCOL,    "MKCOL",
+    Method::COPY,     "COPY",
+    Method::MOVE,     "MOVE",
+    Method::LOCK,     "LOCK",
+    Method::UNLOCK,   "UNLOCK"
+);
+
+const std::unordered_map<std::string_view, Method>* g_unordered = nullptr;
+const std::map<std::string_view, Method>* g_ordered = nullptr;
+
+using SortedEntry = std::pair<std::string_view, Method>;
+constexpr std::array<SortedEntry, 16> SORTED = [] {
+    std::array<SortedEntry, 16> out{};
+    for (std::size_t i = 0; i < 16; i++) {
+        out[i] = {METHOD_NAMES[i], static_cast<Method>(i)};
+    }
+    std::sort(out.begin(), out.end());
+    return out;
+}();
+
+} // namespace
+
+// Each implementation sits behind a non-inlined C symbol so its code size can
+// be read from the symbol table. They return the enum value, or -1 on a miss.
+extern "C" {
+
+[[gnu::noinline]] int topname_cmp_enum_string(const char* p, std::size_t n) {
+    try {
+        return enum_to_underlying(methods.to_enum({p, n}));
+    } catch (const EnumStringException&) {
+        return -1;
+    }
+}
+
+[[gnu::noinline]] int topname_cmp_unordered_map(const char* p, std::size_t n) {
+    auto it = g_unordered->find({p, n});
+    return it == g_unordered->end() ? -1 : enum_to_underlying(it->second);
+}
+
+[[gnu::noinline]] int topname_cmp_map(const char* p, std::size_t n) {
+    auto it = g_ordered->find({p, n});
+    return it == g_ordered->end() ? -1 : enum_to_underlying(it->second);
+}
+
+[[gnu::noinline]] int topname_cmp_sorted_array(const char* p, std::size_t n) {
+    std::string_view key(p, n);
+    auto it = std::lower_bound(SORTED.begin(), SORTED.end(), key,
+        [](const SortedEntry& entry, std::string_view k) { return entry.first < k; });
+    return it == SORTED.end() || it->first != key ? -1 : enum_to_underlying(it->second);
+}
+
+[[gnu::noinline]] int topname_cmp_if_else(const char* p, std::size_t n) {
+    std::string_view key(p, n);
+    if (key == "GET") return 0;
+    else if (key == "HEAD") return 1;
+    else if (key == "POST") return 2;
+    else if (key == "PUT") return 3;
+    else if (key == "DELETE") return 4;
+    else if (key == "CONNECT") return 5;
+    else if (key == "OPTIONS") return 6;
+    else if (key == "TRACE") return 7;
+    else if (key == "PATCH") return 8;
+    else if (key == "PROPFIND") return 9;
+    else if (key == "PROPPATCH") return 10;
+    else if (key == "MKCOL") return 11;
+    else if (key == "COPY") return 12;
+    else if (key == "MOVE") return 13;
+    else if (key == "LOCK") return 14;
+    else if (key == "UNLOCK") return 15;
+    return -1;
+}
+
+[[gnu::noinline]] int topname_cmp_switch(const char* p, std::size_t n) {
+    switch (n) {
+        case 3:
+            if (std::memcmp(p, "GET", 3) == 0) return 0;
+            if (std::memcmp(p, "PUT", 3) == 0) return 3;
+            break;
+        case 4:
+            switch (p[0]) {
+                case 'H': return std::memcmp(p, "HEAD", 4) == 0 ? 1 : -1;
+                case 'P': return std::memcmp(p, "POST", 4) == 0 ? 2 : -1;
+                case 'C': return std::memcmp(p, "COPY", 4) == 0 ? 12 : -1;
+                case 'M': return std::memcmp(p, "MOVE", 4) == 0 ? 13 : -1;
+                case 'L': return std::memcmp(p, "LOCK", 4) == 0 ? 14 : -1;
+            }
+            break;
+        case 5:
+            switch (p[0]) {
+                case 'T': return std::memcmp(p, "TRACE", 5) == 0 ? 7 : -1;
+                case 'P': return std::memcmp(p, "PATCH", 5) == 0 ? 8 : -1;
+                case 'M': return std::memcmp(p, "MKCOL", 5) == 0 ? 11 : -1;
+            }
+            break;
+        case 6:
+            if (std::memcmp(p, "DELETE", 6) == 0) return 4;
+            if (std::memcmp(p, "UNLOCK", 6) == 0) return 15;
+            break;
+        case 7:
+            if (std::memcmp(p, "CONNECT", 7) == 0) return 5;
+            if (std::memcmp(p, "OPTIONS", 7) == 0) return 6;
+            break;
+        case 8:
+            return std::memcmp(p, "PROPFIND", 8) == 0 ? 9 : -1;
+        case 9:
+            return std::memcmp(p, "PROPPATCH", 9) == 0 ? 10 : -1;
+    }
+    return -1;
+}
+
+} // extern "C"
+
+namespace {
+
+using LookupFn = int (*)(const char*, std::size_t);
+
+struct Candidate {
+    const char* name;
+    const char* symbol;
+    LookupFn fn;
+    std::size_t table_bytes;
+};
+
+struct Workload {
+    const char* name;
+    std::vector<std::string_view> inputs;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto min_time = std::chrono::milliseconds(50);
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            min_time = std::chrono::milliseconds(5);
+        }
+    }
+
+    std::size_t before = g_allocated;
+    std::unordered_map<std::string_view, Method> unordered;
+    for (std::size_t i = 0; i < 16; i++) {
+        unordered.emplace(METHOD_NAMES[i], static_cast<Method>(i));
+    }
+    std::size_t unordered_bytes = sizeof(unordered) + g_allocated - before;
+    g_unordered = &unordered;
+
+    before = g_allocated;
+    std::map<std::string_view, Method> ordered;
+    for (std::size_t i = 0; i < 16; i++) {
+        ordered.emplace(METHOD_NAMES[i], static_cast<Method>(i));
+    }
+    std::size_t ordered_bytes = sizeof(ordered) + g_allocated - before;
+    g_ordered = &ordered;
+
+    const std::array<Candidate, 6> candidates{{
+        {"EnumString", "topname_cmp_enum_string", topname_cmp_enum_string, sizeof(methods)},
+        {"std::unordered_map", "topname_cmp_unordered_map", topname_cmp_unordered_map, unordered_bytes},
+        {"std::map", "topname_cmp_map", topname_cmp_map, ordered_bytes},
+        {"sorted std::array", "topname_cmp_sorted_array", topname_cmp_sorted_array, sizeof(SORTED)},
+        {"if/else chain", "topname_cmp_if_else", topname_cmp_if_else, 0},
+        {"switch", "topname_cmp_switch", topname_cmp_switch, 0},
+    }};
+
+    std::mt19937_64 rng(7);
+    constexpr std::size_t INPUTS = 4096;
+    static const std::array<std::string_view, 4> MISSES{"PURGE", "get", "SEARCH", "UNLINK"};
+    std::vector<Workload> workloads;
+    for (Distribution dist : ALL_DISTRIBUTIONS) {
+        Workload w{distribution_name(dist), {}};
+        for (uint32_t idx : make_indices(dist, METHOD_NAMES.size(), INPUTS, rng)) {
+            w.inputs.push_back(METHOD_NAMES[idx]);
+        }
+        workloads.push_back(std::move(w));
+    }
+    Workload mixed{"25% miss", {}};
+    for (uint32_t idx : make_indices(Distribution::Uniform, 4 * MISSES.size(), INPUTS, rng)) {
+        mixed.inputs.push_back(idx < MISSES.size() ? MISSES[idx] : METHOD_NAMES[idx % METHOD_NAMES.size()]);
+    }
+    workloads.push_back(std::move(mixed));
+
+    // All candidates must agree before anything is timed.
+    for (const Workload& w : workloads) {
+        for (std::string_view key : w.inputs) {
+            int expected = candidates[0].fn(key.data(), key.size());
+            for (const Candidate& c : candidates) {
+                if (c.fn(key.data(), key.size()) != expected) {
+                    std::fprintf(stderr, "%s disagrees on '%.*s'\n", c.name,
+                                 static_cast<int>(key.size()), key.data());
+                    return 1;
+                }
+            }
+        }
+    }
+
+    std::map<std::string, uint64_t> symbols = ElfSizes("/proc/self/exe").symbols();
+
+    std::printf("%-20s %-10s %10s %12s %8s %8s\n", "implementation", "workload", "ns/op", "Mlookups/s", "code B", "table B");
+    for (const Workload& w : workloads) {
+        for (const Candidate& c : candidates) {
+            Result r = measure(w.inputs.size(), [&](std::size_t i) {
+                do_not_optimize(c.fn(w.inputs[i].data(), w.inputs[i].size()));
+            }, min_time);
+            auto sym = symbols.find(c.symbol);
+            std::string code = sym == symbols.end() ? "n/a" : std::to_string(sym->second);
+            std::printf("%-20s %-10s %10.2f %12.1f %8s %8zu\n", c.name, w.name, r.ns_per_op,
+                        1e3 / r.ns_per_op, code.c_str(), c.table_bytes);
+        }
+    }
+    return 0;
+}
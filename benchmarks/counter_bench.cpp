@@ -0,0 +1,219 @@
+// Hardware counter profile of the EnumString lookup kernels.
+//
+// Wraps each operation in a self-calibrating loop: the iteration count doubles
+// until one run takes at least the target time, then the loop is repeated and
+// the repetition with the fewest cycles is kept. Counter deltas are divided by
+// the iteration count after subtracting an empty loop over the same inputs,
+// giving cycles, instructions, branch misses and L1d read misses per lookup.
+//
+// Counters come from perf_event_open (Linux). Where they can not be opened,
+// e.g. inside containers or with a restrictive perf_event_paranoid, the
+// harness falls back to the time-stamp counter (rdtsc on x86, cntvct_el0 on
+// AArch64, steady_clock elsewhere) and reports reference cycles only.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/counter_bench.cpp -o counter_bench
+// Usage: counter_bench [--quick]
+
+#include <cstring>
+#include <memory>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+#include "bench_common.hpp"
+#include "perf_counters.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t INPUTS = 1024;
+constexpr std::size_t REPETITIONS = 5;
+
+std::chrono::nanoseconds g_target = std::chrono::milliseconds(10);
+
+const std::vector<PerfEvent> EVENTS = {
+    PerfEvent::Cycles, PerfEvent::Instructions, PerfEvent::BranchMisses, PerfEvent::L1DReadMisses,
+};
+
+/**
+ * @brief Reads the time-stamp counter used when hardware counters are unavailable.
+ */
+inline uint64_t read_tsc() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t value;
+    asm volatile("mrs %0, cntvct_el0" : "=r"(value));
+    return value;
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+}
+
+/**
+ * @brief Counter deltas of one loop, one value per entry of EVENTS plus the TSC.
+ */
+struct Sample {
+    std::vector<double> counters;
+    double tsc;
+};
+
+class Harness {
+public:
+    Harness() : m_perf(EVENTS) {}
+
+    bool hardware() const { return m_perf.available(); }
+    bool available(std::size_t event) const { return m_perf.available(event); }
+
+    /**
+     * @brief Measures op(i) and returns per-op deltas with the loop overhead removed.
+     */
+    template<typename Op>
+    Sample per_op(const Op& op) {
+        std::size_t iterations = calibrate(op);
+        Sample kernel = best_of(op, iterations);
+        Sample empty = best_of([](std::size_t i) { do_not_optimize(i); }, iterations);
+        Sample out{std::vector<double>(EVENTS.size()), 0};
+        for (std::size_t e = 0; e < EVENTS.size(); e++) {
+            out.counters[e] = std::max(0.0, kernel.counters[e] - empty.counters[e]) / iterations;
+        }
+        out.tsc = std::max(0.0, kernel.tsc - empty.tsc) / iterations;
+        return out;
+    }
+
+private:
+    PerfCounters m_perf;
+
+    template<typename Op>
+    Sample run(const Op& op, std::size_t iterations) {
+        m_perf.start();
+        uint64_t tsc_start = read_tsc();
+        std::size_t cursor = 0;
+        for (std::size_t i = 0; i < iterations; i++) {
+            op(cursor);
+            if (++cursor == INPUTS) {
+                cursor = 0;
+            }
+        }
+        uint64_t tsc_end = read_tsc();
+        std::vector<uint64_t> values = m_perf.stop();
+        return {std::vector<double>(values.begin(), values.end()), static_cast<double>(tsc_end - tsc_start)};
+    }
+
+    template<typename Op>
+    std::size_t calibrate(const Op& op) {
+        std::size_t iterations = INPUTS;
+        while (true) {
+            auto start = std::chrono::steady_clock::now();
+            run(op, iterations);
+            if (std::chrono::steady_clock::now() - start >= g_target || iterations >= (std::size_t{1} << 30)) {
+                return iterations;
+            }
+            iterations *= 2;
+        }
+    }
+
+    template<typename Op>
+    Sample best_of(const Op& op, std::size_t iterations) {
+        Sample best = run(op, iterations);
+        for (std::size_t r = 1; r < REPETITIONS; r++) {
+            Sample s = run(op, iterations);
+            // Rank by cycles when counted, otherwise by TSC ticks.
+            bool better = available(0) ? s.counters[0] < best.counters[0] : s.tsc < best.tsc;
+            if (better) {
+                best = std::move(s);
+            }
+        }
+        return best;
+    }
+};
+
+void print_header(const Harness& harness) {
+    std::printf("%-22s %6s", "operation", "N");
+    if (harness.hardware()) {
+        for (PerfEvent event : EVENTS) {
+            std::printf(" %13s", perf_event_name(event));
+        }
+        std::printf(" %8s", "IPC");
+    }
+    std::printf(" %10s\n", "tsc ticks");
+}
+
+void print_sample(const Harness& harness, std::string_view op, std::size_t n, const Sample& s) {
+    std::printf("%-22.*s %6zu", static_cast<int>(op.size()), op.data(), n);
+    if (harness.hardware()) {
+        for (std::size_t e = 0; e < EVENTS.size(); e++) {
+            if (harness.available(e)) {
+                std::printf(" %13.2f", s.counters[e]);
+            } else {
+                std::printf(" %13s", "n/a");
+            }
+        }
+        if (harness.available(0) && harness.available(1) && s.counters[0] > 0) {
+            std::printf(" %8.2f", s.counters[1] / s.counters[0]);
+        } else {
+            std::printf(" %8s", "n/a");
+        }
+    }
+    std::printf(" %10.2f\n", s.tsc);
+}
+
+template<std::size_t N>
+void run_size(Harness& harness, std::mt19937_64& rng) {
+    std::vector<std::string> keys = make_keys(KeyShape::Short, 2 * N, rng);
+    std::vector<std::string> misses(keys.begin() + N, keys.end());
+    keys.resize(N);
+    auto table = std::make_unique<EnumString<Key, N>>(make_table<N>(keys));
+
+    std::vector<uint32_t> indices = make_indices(Distribution::Uniform, N, INPUTS, rng);
+    std::vector<std::string_view> hits(INPUTS);
+    std::vector<std::string> scrambled(INPUTS);
+    std::vector<std::string_view> miss_inputs(INPUTS);
+    std::vector<Key> enums(INPUTS);
+    for (std::size_t i = 0; i < INPUTS; i++) {
+        hits[i] = keys[indices[i]];
+        scrambled[i] = scramble_case(keys[indices[i]], rng);
+        miss_inputs[i] = misses[indices[i]];
+        enums[i] = static_cast<Key>(indices[i]);
+    }
+
+    const auto& t = *table;
+    auto report = [&](std::string_view name, const auto& op) {
+        print_sample(harness, name, N, harness.per_op(op));
+    };
+    report("to_enum hit", [&](std::size_t i) { do_not_optimize(t.to_enum(hits[i])); });
+    report("to_enum_insensitive", [&](std::size_t i) { do_not_optimize(t.to_enum_insensitive(scrambled[i])); });
+    report("to_string", [&](std::size_t i) { do_not_optimize(t.to_string(enums[i])); });
+    report("contains(string) hit", [&](std::size_t i) { do_not_optimize(t.contains(hits[i])); });
+    report("contains(string) miss", [&](std::size_t i) { do_not_optimize(t.contains(miss_inputs[i])); });
+    report("contains(enum)", [&](std::size_t i) { do_not_optimize(t.contains(enums[i])); });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    if (quick) {
+        g_target = std::chrono::milliseconds(2);
+    }
+
+    Harness harness;
+    if (harness.hardware()) {
+        std::printf("hardware counters: available, values per lookup\n");
+    } else {
+        std::printf("hardware counters: unavailable, falling back to time-stamp counter ticks per lookup\n");
+    }
+    print_header(harness);
+
+    std::mt19937_64 rng(5);
+    run_size<8>(harness, rng);
+    run_size<64>(harness, rng);
+    run_size<512>(harness, rng);
+    if (!quick) {
+        run_size<4096>(harness, rng);
+    }
+    return 0;
+}
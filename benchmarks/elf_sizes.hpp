@@ -0,0 +1,117 @@
+#ifndef TOPNAME_BENCH_ELF_SIZES_H
+#define TOPNAME_BENCH_ELF_SIZES_H
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace Topname::bench {
+
+/**
+ * @brief Minimal reader for the section and symbol sizes of a 64-bit little-endian ELF file.
+ *
+ * Lets the benchmarks report code and data sizes without binutils. Every
+ * function returns an empty map for anything that is not such a file.
+ */
+class ElfSizes {
+public:
+    explicit ElfSizes(const std::string& path) {
+        std::ifstream in(path, std::ios::binary);
+        m_data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        m_valid = m_data.size() >= 64 && std::memcmp(m_data.data(), "\x7f" "ELF", 4) == 0
+               && m_data[4] == 2 /* ELFCLASS64 */ && m_data[5] == 1 /* little endian */;
+    }
+
+    /**
+     * @brief Returns the size of every section by name (.text, .rodata, ...).
+     */
+    std::map<std::string, uint64_t> sections() const {
+        std::map<std::string, uint64_t> out;
+        std::vector<Section> headers = section_headers();
+        uint16_t shstrndx = read<uint16_t>(0x3e);
+        if (shstrndx >= headers.size()) {
+            return out;
+        }
+        uint64_t names = headers[shstrndx].offset;
+        for (const Section& section : headers) {
+            if (names + section.name < m_data.size()) {
+                out[m_data.data() + names + section.name] += section.size;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Returns the size of every symbol in the symbol table by (mangled) name.
+     */
+    std::map<std::string, uint64_t> symbols() const {
+        std::map<std::string, uint64_t> out;
+        std::vector<Section> headers = section_headers();
+        for (const Section& symtab : headers) {
+            if (symtab.type != 2 /* SHT_SYMTAB */ || symtab.link >= headers.size()) {
+                continue;
+            }
+            const Section& strtab = headers[symtab.link];
+            for (uint64_t off = 0; off + 24 <= symtab.size; off += 24) {
+                uint64_t sym = symtab.offset + off;
+                if (sym + 24 > m_data.size()) {
+                    break;
+                }
+                uint32_t name = read<uint32_t>(sym);
+                uint64_t size = read<uint64_t>(sym + 16);
+                if (name != 0 && strtab.offset + name < m_data.size()) {
+                    out[m_data.data() + strtab.offset + name] = size;
+                }
+            }
+        }
+        return out;
+    }
+
+private:
+    struct Section {
+        uint32_t name;
+        uint32_t type;
+        uint64_t offset;
+        uint64_t size;
+        uint32_t link;
+    };
+
+    std::vector<char> m_data;
+    bool m_valid = false;
+
+    template<typename T>
+    T read(uint64_t offset) const {
+        T value{};
+        if (offset + sizeof(T) <= m_data.size()) {
+            std::memcpy(&value, m_data.data() + offset, sizeof(T));
+        }
+        return value;
+    }
+
+    std::vector<Section> section_headers() const {
+        std::vector<Section> out;
+        if (!m_valid) {
+            return out;
+        }
+        uint64_t shoff = read<uint64_t>(0x28);
+        uint16_t shentsize = read<uint16_t>(0x3a);
+        uint16_t shnum = read<uint16_t>(0x3c);
+        for (uint16_t i = 0; i < shnum; i++) {
+            uint64_t sh = shoff + uint64_t{i} * shentsize;
+            if (sh + 64 > m_data.size()) {
+                break;
+            }
+            out.push_back({read<uint32_t>(sh), read<uint32_t>(sh + 4), read<uint64_t>(sh + 0x18),
+                           read<uint64_t>(sh + 0x20), read<uint32_t>(sh + 0x28)});
+        }
+        return out;
+    }
+};
+
+} // namespace Topname::bench
+
+#endif // TOPNAME_BENCH_ELF_SIZES_H
@@ -0,0 +1,255 @@
+// Calibrates the engine cost model of EnumString.
+//
+// Times to_enum() hits with every engine forced through with_engine() over a
+// sweep of table sizes and key shapes, then fits the constants of
+// EngineCostModel by least squares against the features engine_costs()
+// charges for. Measurements are medians over batches of lookups, so that
+// interruptions on a busy machine do not skew the fit. Prints measured and
+// predicted ns/op, whether Engine::Auto picks the fastest engine under the
+// fitted and the built-in model, and the fitted model as the
+// -DTOPNAME_ENGINE_COST_MODEL flag that makes it the built-in one.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/engine_bench.cpp -o engine_bench
+// Usage: engine_bench [--quick]
+
+#include <cstring>
+#include <functional>
+#include <memory>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t INPUTS = 4096;
+constexpr std::array<Engine, 3> ENGINES{Engine::LinearScan, Engine::HashProbe, Engine::PerfectHash};
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+/**
+ * @brief The model fields, in the order of EngineCostModel.
+ */
+constexpr std::array<double EngineCostModel::*, 7> FIELDS{
+    &EngineCostModel::scan_fixed, &EngineCostModel::scan_entry, &EngineCostModel::compare_byte,
+    &EngineCostModel::hash_byte, &EngineCostModel::hash_fixed, &EngineCostModel::probe,
+    &EngineCostModel::perfect_fixed,
+};
+constexpr std::array<const char*, 7> FIELD_NAMES{
+    "scan_fixed", "scan_entry", "compare_byte", "hash_byte", "hash_fixed", "probe", "perfect_fixed",
+};
+
+double engine_cost(const EngineCosts& costs, Engine engine) {
+    switch (engine) {
+        case Engine::LinearScan: return costs.linear_scan;
+        case Engine::HashProbe: return costs.hash_probe;
+        case Engine::PerfectHash: return costs.perfect_hash;
+        case Engine::Auto: break;
+    }
+    return 0.0;
+}
+
+struct Row {
+    KeyShape shape;
+    std::size_t n;
+    Engine engine;
+    double measured;
+    std::array<double, 7> features; /**< Cost under a model with only one field set to 1. */
+    std::function<EngineCosts(const EngineCostModel&)> costs;
+};
+
+template<std::size_t N>
+void run_size(KeyShape shape, std::mt19937_64& rng, std::vector<Row>& rows) {
+    std::vector<std::string> keys = make_keys(shape, N, rng);
+    auto base = std::make_shared<EnumString<Key, N>>(make_table<N>(keys));
+    std::vector<uint32_t> indices = make_indices(Distribution::Uniform, N, INPUTS, rng);
+    std::vector<std::string_view> inputs(INPUTS);
+    for (std::size_t i = 0; i < INPUTS; i++) {
+        inputs[i] = keys[indices[i]];
+    }
+
+    for (Engine engine : ENGINES) {
+        if (engine_cost(base->engine_costs(), engine) == std::numeric_limits<double>::infinity()) {
+            continue; // Hash collision: no perfect hash exists.
+        }
+        auto table = std::make_unique<EnumString<Key, N>>(base->with_engine(engine));
+        Result r = measure(INPUTS, [&](std::size_t i) { do_not_optimize(table->to_enum(inputs[i])); }, g_min_time);
+
+        Row row{shape, N, engine, r.p50, {}, [base](const EngineCostModel& m) { return base->engine_costs(m); }};
+        for (std::size_t f = 0; f < FIELDS.size(); f++) {
+            EngineCostModel unit{};
+            unit.*FIELDS[f] = 1.0;
+            row.features[f] = engine_cost(base->engine_costs(unit), engine);
+        }
+        rows.push_back(std::move(row));
+    }
+}
+
+/**
+ * @brief Least-squares fit of measured = sum(coef[f] * features[f]) over the given fields.
+ *
+ * Errors are weighted relative to the measurement, so that the large
+ * tables do not drown the small ones where the engines are close.
+ */
+std::vector<double> fit(const std::vector<const Row*>& rows, const std::vector<std::size_t>& fields) {
+    std::size_t k = fields.size();
+    std::vector<std::vector<double>> a(k, std::vector<double>(k + 1, 0.0));
+    for (const Row* row : rows) {
+        double weight = 1.0 / (row->measured * row->measured);
+        for (std::size_t i = 0; i < k; i++) {
+            for (std::size_t j = 0; j < k; j++) {
+                a[i][j] += weight * row->features[fields[i]] * row->features[fields[j]];
+            }
+            a[i][k] += weight * row->features[fields[i]] * row->measured;
+        }
+    }
+    // Gaussian elimination with partial pivoting.
+    for (std::size_t c = 0; c < k; c++) {
+        std::size_t pivot = c;
+        for (std::size_t r = c + 1; r < k; r++) {
+            if (std::abs(a[r][c]) > std::abs(a[pivot][c])) {
+                pivot = r;
+            }
+        }
+        std::swap(a[c], a[pivot]);
+        if (std::abs(a[c][c]) < 1e-12) {
+            continue;
+        }
+        for (std::size_t r = 0; r < k; r++) {
+            if (r != c) {
+                double factor = a[r][c] / a[c][c];
+                for (std::size_t j = c; j <= k; j++) {
+                    a[r][j] -= factor * a[c][j];
+                }
+            }
+        }
+    }
+    std::vector<double> coef(k, 0.0);
+    for (std::size_t i = 0; i < k; i++) {
+        if (std::abs(a[i][i]) >= 1e-12) {
+            coef[i] = std::max(0.0, a[i][k] / a[i][i]); // Negative costs are noise.
+        }
+    }
+    return coef;
+}
+
+std::vector<const Row*> rows_of(const std::vector<Row>& rows, Engine engine) {
+    std::vector<const Row*> out;
+    for (const Row& row : rows) {
+        if (row.engine == engine) {
+            out.push_back(&row);
+        }
+    }
+    return out;
+}
+
+EngineCostModel calibrate(const std::vector<Row>& rows) {
+    EngineCostModel model{};
+    auto scan = fit(rows_of(rows, Engine::LinearScan), {0, 1, 2});
+    model.scan_fixed = scan[0];
+    model.scan_entry = scan[1];
+    model.compare_byte = scan[2];
+
+    auto probe = fit(rows_of(rows, Engine::HashProbe), {3, 4, 5});
+    model.hash_byte = probe[0];
+    model.hash_fixed = probe[1];
+    model.probe = probe[2];
+
+    // PerfectHash shares hash_byte with HashProbe; its fixed cost is the median residual.
+    std::vector<double> residuals;
+    for (const Row* row : rows_of(rows, Engine::PerfectHash)) {
+        residuals.push_back(row->measured - model.hash_byte * row->features[3]);
+    }
+    if (!residuals.empty()) {
+        std::nth_element(residuals.begin(), residuals.begin() + residuals.size() / 2, residuals.end());
+        model.perfect_fixed = std::max(0.0, residuals[residuals.size() / 2]);
+    }
+    return model;
+}
+
+double predict(const Row& row, const EngineCostModel& model) {
+    double total = 0.0;
+    for (std::size_t f = 0; f < FIELDS.size(); f++) {
+        total += row.features[f] * (model.*FIELDS[f]);
+    }
+    return total;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    if (quick) {
+        g_min_time = std::chrono::milliseconds(2);
+    }
+
+    std::mt19937_64 rng(3);
+    std::vector<Row> rows;
+    for (KeyShape shape : ALL_SHAPES) {
+        run_size<2>(shape, rng, rows);
+        run_size<4>(shape, rng, rows);
+        run_size<8>(shape, rng, rows);
+        run_size<16>(shape, rng, rows);
+        run_size<32>(shape, rng, rows);
+        run_size<64>(shape, rng, rows);
+        run_size<256>(shape, rng, rows);
+        if (!quick) {
+            run_size<1024>(shape, rng, rows);
+        }
+    }
+
+    EngineCostModel fitted = calibrate(rows);
+
+    std::printf("%-7s %6s %-22s %10s %10s\n", "keys", "N", "engine", "ns/op", "predicted");
+    for (const Row& row : rows) {
+        std::string_view name = engine_name(row.engine);
+        std::printf("%-7s %6zu %-22.*s %10.2f %10.2f\n", shape_name(row.shape), row.n,
+                    static_cast<int>(name.size()), name.data(), row.measured, predict(row, fitted));
+    }
+
+    // Per table: does the cheapest predicted engine match the fastest measured one?
+    std::size_t tables = 0, fitted_hits = 0, default_hits = 0;
+    double fitted_loss = 0.0, default_loss = 0.0;
+    for (std::size_t i = 0; i < rows.size();) {
+        std::size_t end = i;
+        const Row* fastest = &rows[i];
+        while (end < rows.size() && rows[end].shape == rows[i].shape && rows[end].n == rows[i].n) {
+            if (rows[end].measured < fastest->measured) {
+                fastest = &rows[end];
+            }
+            end++;
+        }
+        auto measured_of = [&](Engine engine) {
+            for (std::size_t j = i; j < end; j++) {
+                if (rows[j].engine == engine) {
+                    return rows[j].measured;
+                }
+            }
+            return fastest->measured;
+        };
+        Engine fitted_pick = rows[i].costs(fitted).cheapest();
+        Engine default_pick = rows[i].costs(DEFAULT_ENGINE_COST_MODEL).cheapest();
+        fitted_hits += fitted_pick == fastest->engine;
+        default_hits += default_pick == fastest->engine;
+        fitted_loss += measured_of(fitted_pick) / fastest->measured - 1.0;
+        default_loss += measured_of(default_pick) / fastest->measured - 1.0;
+        tables++;
+        i = end;
+    }
+    std::printf("\nfastest engine chosen: fitted model %zu/%zu (%.1f%% slower on average), "
+                "built-in model %zu/%zu (%.1f%% slower on average)\n",
+                fitted_hits, tables, 100.0 * fitted_loss / tables,
+                default_hits, tables, 100.0 * default_loss / tables);
+
+    std::printf("\nfitted model:");
+    for (std::size_t f = 0; f < FIELDS.size(); f++) {
+        std::printf(" %s=%.3f", FIELD_NAMES[f], fitted.*FIELDS[f]);
+    }
+    std::printf("\n-DTOPNAME_ENGINE_COST_MODEL='{");
+    for (std::size_t f = 0; f < FIELDS.size(); f++) {
+        std::printf("%s%.3f", f == 0 ? "" : ", ", fitted.*FIELDS[f]);
+    }
+    std::printf("}'\n");
+    return 0;
+}
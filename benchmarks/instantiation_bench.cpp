@@ -0,0 +1,161 @@
+// Compile-time and binary-size cost of EnumString instantiations.
+//
+// Generates translation units holding K distinct enums of N values each, with
+// one EnumString per enum and a function exercising the usual members
+// (to_enum, to_string, contains, for_each_pair, iteration). Each unit is
+// compiled to an object file; the benchmark reports wall-clock compile time,
+// object size, .text and .rodata sizes, and the per-table cost after
+// subtracting a unit that only includes the header.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/instantiation_bench.cpp -o instantiation_bench
+// Usage: instantiation_bench [--cxx COMPILER] [--flags "FLAGS"] [--include DIR]
+//                            [--keep] [K:N ...]
+//        e.g. instantiation_bench --include include 1:8 50:8 50:64
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "elf_sizes.hpp"
+
+namespace fs = std::filesystem;
+using Topname::bench::ElfSizes;
+
+namespace {
+
+struct Config {
+    std::string cxx = "c++";
+    std::string flags = "-std=c++20 -O2";
+    std::string include_dir = "include";
+    bool keep = false;
+    std::vector<std::pair<std::size_t, std::size_t>> shapes; /**< (K, N) pairs. */
+};
+
+struct Measurement {
+    double seconds;
+    uint64_t object_bytes;
+    uint64_t text_bytes;
+    uint64_t rodata_bytes;
+};
+
+void write_unit(const fs::path& path, std::size_t k, std::size_t n) {
+    std::ofstream out(path);
+    out << "#include <Topname/Topname.hpp>\n#include <cstddef>\n\n";
+    for (std::size_t e = 0; e < k; e++) {
+        out << "enum class Enum" << e << " {";
+        for (std::size_t v = 0; v < n; v++) {
+            out << (v ? ", " : " ") << 'V' << v;
+        }
+        out << " };\n";
+        out << "constexpr auto table" << e << " = Topname::EnumString(";
+        for (std::size_t v = 0; v < n; v++) {
+            out << (v ? ",\n    " : "\n    ") << "Enum" << e << "::V" << v << ", \"Enum" << e << "_V" << v << '"';
+        }
+        out << ");\n";
+        out << "std::size_t use" << e << "(std::string_view s, int v) {\n"
+            << "    std::size_t total = Topname::enum_to_underlying(table" << e << ".to_enum(s));\n"
+            << "    total += table" << e << ".to_string(static_cast<Enum" << e << ">(v)).size();\n"
+            << "    total += table" << e << ".contains(s) + table" << e << ".contains(static_cast<Enum" << e << ">(v));\n"
+            << "    table" << e << ".for_each_pair([&](Enum" << e << ", std::string_view str) { total += str.size(); });\n"
+            << "    for (const auto& pair : table" << e << ") { total += pair.string_val.size(); }\n"
+            << "    return total;\n}\n\n";
+    }
+}
+
+Measurement compile(const Config& config, const fs::path& source) {
+    fs::path object = fs::path(source).replace_extension(".o");
+    std::string command = config.cxx + " " + config.flags + " -I\"" + config.include_dir + "\" -c \""
+                        + source.string() + "\" -o \"" + object.string() + "\"";
+    auto start = std::chrono::steady_clock::now();
+    int status = std::system(command.c_str());
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (status != 0) {
+        std::fprintf(stderr, "compilation failed: %s\n", command.c_str());
+        std::exit(1);
+    }
+
+    auto sections = ElfSizes(object.string()).sections();
+    auto section_total = [&sections](const std::string& prefix) {
+        uint64_t total = 0;
+        for (const auto& [name, size] : sections) {
+            // Count .text.* and .rodata.* too: inline and template functions land in COMDAT sections.
+            if (name == prefix || name.rfind(prefix + ".", 0) == 0) {
+                total += size;
+            }
+        }
+        return total;
+    };
+    return {seconds, static_cast<uint64_t>(fs::file_size(object)), section_total(".text"), section_total(".rodata")};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Config config;
+    if (const char* cxx = std::getenv("CXX")) {
+        config.cxx = cxx;
+    }
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--cxx" && i + 1 < argc) {
+            config.cxx = argv[++i];
+        } else if (arg == "--flags" && i + 1 < argc) {
+            config.flags = argv[++i];
+        } else if (arg == "--include" && i + 1 < argc) {
+            config.include_dir = argv[++i];
+        } else if (arg == "--keep") {
+            config.keep = true;
+        } else if (auto colon = arg.find(':'); colon != std::string::npos) {
+            config.shapes.emplace_back(std::stoul(arg.substr(0, colon)), std::stoul(arg.substr(colon + 1)));
+        } else {
+            std::fprintf(stderr, "unknown argument: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (config.shapes.empty()) {
+        config.shapes = {{1, 8}, {10, 8}, {50, 8}, {10, 64}, {50, 64}};
+    }
+    config.include_dir = fs::absolute(config.include_dir).string();
+
+    auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    fs::path dir = fs::temp_directory_path() / ("topname_instantiation_" + std::to_string(stamp));
+    fs::create_directories(dir);
+
+    fs::path baseline_source = dir / "baseline.cpp";
+    write_unit(baseline_source, 0, 0);
+    Measurement baseline = compile(config, baseline_source);
+
+    std::printf("compiler: %s %s\n", config.cxx.c_str(), config.flags.c_str());
+    std::printf("%5s %5s %10s %10s %10s %10s %12s %12s %12s\n", "K", "N", "compile s", "object B",
+                ".text B", ".rodata B", "ms/table", ".text/table", ".rodata/table");
+    std::printf("%5d %5d %10.3f %10llu %10llu %10llu %12s %12s %12s\n", 0, 0, baseline.seconds,
+                static_cast<unsigned long long>(baseline.object_bytes),
+                static_cast<unsigned long long>(baseline.text_bytes),
+                static_cast<unsigned long long>(baseline.rodata_bytes), "-", "-", "-");
+
+    for (auto [k, n] : config.shapes) {
+        fs::path source = dir / ("unit_" + std::to_string(k) + "x" + std::to_string(n) + ".cpp");
+        write_unit(source, k, n);
+        Measurement m = compile(config, source);
+        double tables = static_cast<double>(k);
+        std::printf("%5zu %5zu %10.3f %10llu %10llu %10llu %12.2f %12.0f %12.0f\n", k, n, m.seconds,
+                    static_cast<unsigned long long>(m.object_bytes),
+                    static_cast<unsigned long long>(m.text_bytes),
+                    static_cast<unsigned long long>(m.rodata_bytes),
+                    (m.seconds - baseline.seconds) * 1e3 / tables,
+                    (static_cast<double>(m.text_bytes) - static_cast<double>(baseline.text_bytes)) / tables,
+                    (static_cast<double>(m.rodata_bytes) - static_cast<double>(baseline.rodata_bytes)) / tables);
+    }
+
+    if (config.keep) {
+        std::printf("sources kept in %s\n", dir.string().c_str());
+    } else {
+        fs::remove_all(dir);
+    }
+    return 0;
+}
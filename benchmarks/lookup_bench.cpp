@@ -0,0 +1,104 @@
+// Microbenchmarks for every EnumString lookup path.
+//
+// Sweeps table sizes from 4 to 4096 with short, long and shared-prefix keys,
+// drawing inputs from uniform and Zipf distributions, and reports mean ns/op
+// together with p50/p99 per-operation latency.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/lookup_bench.cpp -o lookup_bench
+// Usage: lookup_bench [--quick]
+
+#include <cstring>
+#include <memory>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t INPUTS = 4096;
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+template<std::size_t N>
+void run_size(KeyShape shape, std::mt19937_64& rng) {
+    std::vector<std::string> keys = make_keys(shape, 2 * N, rng);
+    std::vector<std::string> misses(keys.begin() + N, keys.end());
+    keys.resize(N);
+    auto table = std::make_unique<EnumString<Key, N>>(make_table<N>(keys));
+
+    for (Distribution dist : ALL_DISTRIBUTIONS) {
+        std::vector<uint32_t> indices = make_indices(dist, N, INPUTS, rng);
+        std::vector<std::string_view> hits(INPUTS);
+        std::vector<std::string> scrambled(INPUTS);
+        std::vector<std::string_view> miss_inputs(INPUTS);
+        std::vector<Key> enums(INPUTS);
+        for (std::size_t i = 0; i < INPUTS; i++) {
+            hits[i] = keys[indices[i]];
+            scrambled[i] = scramble_case(keys[indices[i]], rng);
+            miss_inputs[i] = misses[indices[i]];
+            enums[i] = static_cast<Key>(indices[i]);
+        }
+
+        print_row("to_enum (hit)", shape, dist, N, measure(INPUTS, [&](std::size_t i) {
+            do_not_optimize(table->to_enum(hits[i]));
+        }, g_min_time));
+
+        print_row("to_enum (miss)", shape, dist, N, measure(INPUTS, [&](std::size_t i) {
+            try {
+                do_not_optimize(table->to_enum(miss_inputs[i]));
+            } catch (const EnumStringException& e) {
+                do_not_optimize(e.error_code());
+            }
+        }, g_min_time));
+
+        print_row("to_enum_insensitive", shape, dist, N, measure(INPUTS, [&](std::size_t i) {
+            do_not_optimize(table->to_enum_insensitive(scrambled[i]));
+        }, g_min_time));
+
+        print_row("to_string", shape, dist, N, measure(INPUTS, [&](std::size_t i) {
+            do_not_optimize(table->to_string(enums[i]));
+        }, g_min_time));
+
+        print_row("contains (string)", shape, dist, N, measure(INPUTS, [&](std::size_t i) {
+            do_not_optimize(table->contains(hits[i]));
+        }, g_min_time));
+
+        print_row("contains (enum)", shape, dist, N, measure(INPUTS, [&](std::size_t i) {
+            do_not_optimize(table->contains(enums[i]));
+        }, g_min_time));
+    }
+
+    // Iteration does not depend on the input distribution; report it per entry.
+    Result iterate = measure(1, [&](std::size_t) {
+        for (const auto& pair : *table) {
+            do_not_optimize(pair.string_val.size());
+        }
+    }, g_min_time);
+    const double n = static_cast<double>(N);
+    print_row("iterate (per entry)", shape, Distribution::Uniform, N,
+              {iterate.ns_per_op / n, iterate.p50 / n, iterate.p99 / n});
+}
+
+template<std::size_t... Sizes>
+void run_sizes(KeyShape shape, std::mt19937_64& rng) {
+    (run_size<Sizes>(shape, rng), ...);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            g_min_time = std::chrono::milliseconds(2);
+        }
+    }
+
+    std::mt19937_64 rng(42);
+    print_header();
+    for (KeyShape shape : ALL_SHAPES) {
+        run_sizes<4, 16, 64, 256, 1024, 4096>(shape, rng);
+    }
+    return 0;
+}
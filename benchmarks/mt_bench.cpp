@@ -0,0 +1,195 @@
+// Multi-threaded scaling of EnumString lookups.
+//
+// Runs to_enum/to_string on 1..64 threads in three layouts:
+//   shared     - one table shared by all threads, per-thread counters padded to a cache line
+//   per-thread - every thread owns a cache-line-aligned copy of the table
+//   packed     - one shared table placed right after unpadded per-thread counters,
+//                the way a table embedded in a mutable object ends up
+// and reports throughput and scaling efficiency relative to one thread. Where
+// perf_event_open is permitted, cache misses per lookup are counted across
+// all threads and layouts with a much higher rate than "shared" at the same
+// thread count are flagged as cache-line contention.
+//
+// Build: g++ -std=c++20 -O2 -pthread -Iinclude benchmarks/mt_bench.cpp -o mt_bench
+// Usage: mt_bench [--quick] [--max-threads N]
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <thread>
+
+#include "bench_common.hpp"
+#include "perf_counters.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t N = 64;
+constexpr std::size_t MAX_THREADS = 64;
+constexpr std::size_t INPUTS = 1024;
+constexpr std::size_t CACHE_LINE = 64;
+
+using Table = EnumString<Key, N>;
+
+enum class Layout { Shared, PerThread, Packed };
+
+const char* layout_name(Layout layout) {
+    switch (layout) {
+        case Layout::Shared: return "shared";
+        case Layout::PerThread: return "per-thread";
+        case Layout::Packed: return "packed";
+    }
+    return "?";
+}
+
+struct alignas(CACHE_LINE) PaddedCounter {
+    uint64_t value = 0;
+};
+
+struct alignas(CACHE_LINE) AlignedTable {
+    Table table;
+};
+
+/**
+ * @brief A table embedded after mutable per-thread counters without padding.
+ */
+struct PackedService {
+    uint64_t hits[MAX_THREADS];
+    Table table;
+};
+
+struct RunResult {
+    double ops_per_second;
+    double cache_misses_per_op; /**< Negative when counters are unavailable. */
+};
+
+struct Inputs {
+    std::vector<std::string_view> keys;
+    std::vector<Key> enums;
+};
+
+/**
+ * @brief Alternates to_enum and to_string until stop is set, bumping counter per op.
+ */
+void lookup_loop(const Table& table, const Inputs& inputs, std::size_t offset,
+                 uint64_t& counter, const std::atomic<bool>& stop) {
+    std::size_t i = offset % INPUTS;
+    while (!stop.load(std::memory_order_relaxed)) {
+        for (std::size_t k = 0; k < 64; k++) {
+            do_not_optimize(table.to_enum(inputs.keys[i]));
+            do_not_optimize(table.to_string(inputs.enums[i]));
+            counter += 2;
+            if (++i == INPUTS) {
+                i = 0;
+            }
+        }
+    }
+}
+
+RunResult run(Layout layout, std::size_t threads, const Table& prototype, const Inputs& inputs,
+              std::chrono::milliseconds duration) {
+    auto counters = std::make_unique<PaddedCounter[]>(threads);
+    auto copies = std::make_unique<AlignedTable[]>(threads);
+    auto packed = std::make_unique<PackedService>(PackedService{{}, prototype});
+    for (std::size_t t = 0; t < threads; t++) {
+        copies[t].table = prototype;
+    }
+
+    std::atomic<bool> stop{false};
+    std::atomic<std::size_t> ready{0};
+    PerfCounters perf({PerfEvent::CacheMisses}, /*inherit=*/true);
+
+    std::vector<std::thread> pool;
+    perf.start();
+    for (std::size_t t = 0; t < threads; t++) {
+        pool.emplace_back([&, t] {
+            ready.fetch_add(1);
+            switch (layout) {
+                case Layout::Shared:
+                    lookup_loop(prototype, inputs, t * 97, counters[t].value, stop);
+                    break;
+                case Layout::PerThread:
+                    lookup_loop(copies[t].table, inputs, t * 97, counters[t].value, stop);
+                    break;
+                case Layout::Packed:
+                    lookup_loop(packed->table, inputs, t * 97, packed->hits[t], stop);
+                    break;
+            }
+        });
+    }
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop.store(true);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::vector<uint64_t> misses = perf.stop();
+
+    uint64_t ops = 0;
+    for (std::size_t t = 0; t < threads; t++) {
+        ops += layout == Layout::Packed ? packed->hits[t] : counters[t].value;
+    }
+    double miss_rate = perf.available() && ops > 0 ? static_cast<double>(misses[0]) / ops : -1.0;
+    return {static_cast<double>(ops) / seconds, miss_rate};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    auto duration = std::chrono::milliseconds(200);
+    std::size_t max_threads = MAX_THREADS;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--quick") == 0) {
+            duration = std::chrono::milliseconds(30);
+        } else if (std::strcmp(argv[i], "--max-threads") == 0 && i + 1 < argc) {
+            max_threads = std::min<std::size_t>(MAX_THREADS, std::strtoul(argv[++i], nullptr, 10));
+        }
+    }
+
+    std::mt19937_64 rng(11);
+    std::vector<std::string> keys = make_keys(KeyShape::Short, N, rng);
+    const Table table = make_table<N>(keys);
+    Inputs inputs;
+    for (uint32_t idx : make_indices(Distribution::Uniform, N, INPUTS, rng)) {
+        inputs.keys.push_back(keys[idx]);
+        inputs.enums.push_back(static_cast<Key>(idx));
+    }
+
+    std::printf("hardware threads: %u, perf counters: %s\n", std::thread::hardware_concurrency(),
+                PerfCounters({PerfEvent::CacheMisses}).available() ? "available" : "unavailable");
+    std::printf("%-11s %7s %12s %11s %14s  %s\n", "layout", "threads", "Mops/s", "efficiency", "misses/lookup", "note");
+
+    for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+        RunResult baseline{};
+        for (Layout layout : {Layout::Shared, Layout::PerThread, Layout::Packed}) {
+            static RunResult single[3];
+            RunResult r = run(layout, threads, table, inputs, duration);
+            if (threads == 1) {
+                single[static_cast<int>(layout)] = r;
+            }
+            if (layout == Layout::Shared) {
+                baseline = r;
+            }
+            double efficiency = r.ops_per_second / (threads * single[static_cast<int>(layout)].ops_per_second);
+            const char* note = threads > std::thread::hardware_concurrency() ? "oversubscribed" : "";
+            if (r.cache_misses_per_op >= 0 && baseline.cache_misses_per_op >= 0 && layout != Layout::Shared
+                && r.cache_misses_per_op > 0.05 && r.cache_misses_per_op > 4 * baseline.cache_misses_per_op) {
+                note = "cache-line contention";
+            }
+            char misses[32] = "n/a";
+            if (r.cache_misses_per_op >= 0) {
+                std::snprintf(misses, sizeof(misses), "%.4f", r.cache_misses_per_op);
+            }
+            std::printf("%-11s %7zu %12.1f %10.0f%% %14s  %s\n", layout_name(layout), threads,
+                        r.ops_per_second / 1e6, efficiency * 100, misses, note);
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,163 @@
+#ifndef TOPNAME_BENCH_PERF_COUNTERS_H
+#define TOPNAME_BENCH_PERF_COUNTERS_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Topname::bench {
+
+/**
+ * @brief A hardware event that PerfCounters can count.
+ */
+enum class PerfEvent {
+    Cycles,
+    Instructions,
+    BranchMisses,
+    CacheMisses,  /**< Last-level cache misses; the closest generic proxy for cache-line transfers. */
+    L1DReadMisses,
+};
+
+inline const char* perf_event_name(PerfEvent event) {
+    switch (event) {
+        case PerfEvent::Cycles: return "cycles";
+        case PerfEvent::Instructions: return "instructions";
+        case PerfEvent::BranchMisses: return "branch-misses";
+        case PerfEvent::CacheMisses: return "cache-misses";
+        case PerfEvent::L1DReadMisses: return "L1d-misses";
+    }
+    return "?";
+}
+
+/**
+ * @brief A set of perf_event_open counters for the calling thread.
+ *
+ * With inherit set, threads created after construction are counted as well.
+ * Each event gets its own file descriptor (inherit does not support group
+ * reads) and readings are scaled by time_enabled/time_running when the kernel
+ * multiplexed them. Events that can not be opened, e.g. inside containers or
+ * with a restrictive perf_event_paranoid, are reported as unavailable.
+ */
+class PerfCounters {
+public:
+    explicit PerfCounters(std::vector<PerfEvent> events, bool inherit = false)
+    : m_events(std::move(events)), m_fds(m_events.size(), -1)
+    {
+#if defined(__linux__)
+        for (std::size_t i = 0; i < m_events.size(); i++) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.disabled = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.inherit = inherit ? 1 : 0;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            configure(m_events[i], attr);
+            m_fds[i] = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#else
+        (void)inherit;
+#endif
+    }
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    ~PerfCounters() {
+#if defined(__linux__)
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief True if at least one event could be opened.
+     */
+    bool available() const {
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief True if the i-th event could be opened.
+     */
+    bool available(std::size_t i) const { return m_fds[i] >= 0; }
+
+    const std::vector<PerfEvent>& events() const { return m_events; }
+
+    /**
+     * @brief Resets and enables all counters.
+     */
+    void start() {
+#if defined(__linux__)
+        for (int fd : m_fds) {
+            if (fd >= 0) {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    /**
+     * @brief Disables all counters and returns their scaled values, 0 for unavailable events.
+     */
+    std::vector<uint64_t> stop() {
+        std::vector<uint64_t> values(m_fds.size(), 0);
+#if defined(__linux__)
+        for (std::size_t i = 0; i < m_fds.size(); i++) {
+            if (m_fds[i] < 0) {
+                continue;
+            }
+            ioctl(m_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            uint64_t data[3] = {0, 0, 0}; // value, time_enabled, time_running
+            if (read(m_fds[i], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)) && data[2] != 0) {
+                values[i] = static_cast<uint64_t>(static_cast<double>(data[0]) * data[1] / data[2]);
+            }
+        }
+#endif
+        return values;
+    }
+
+private:
+    std::vector<PerfEvent> m_events;
+    std::vector<int> m_fds;
+
+#if defined(__linux__)
+    static void configure(PerfEvent event, perf_event_attr& attr) {
+        attr.type = PERF_TYPE_HARDWARE;
+        switch (event) {
+            case PerfEvent::Cycles: attr.config = PERF_COUNT_HW_CPU_CYCLES; break;
+            case PerfEvent::Instructions: attr.config = PERF_COUNT_HW_INSTRUCTIONS; break;
+            case PerfEvent::BranchMisses: attr.config = PERF_COUNT_HW_BRANCH_MISSES; break;
+            case PerfEvent::CacheMisses: attr.config = PERF_COUNT_HW_CACHE_MISSES; break;
+            case PerfEvent::L1DReadMisses:
+                attr.type = PERF_TYPE_HW_CACHE;
+                attr.config = PERF_COUNT_HW_CACHE_L1D
+                            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+                break;
+        }
+    }
+#endif
+};
+
+} // namespace Topname::bench
+
+#endif // TOPNAME_BENCH_PERF_COUNTERS_H
@@ -0,0 +1,103 @@
+// Looking up quoted JSON tokens with and without an unescaped copy.
+//
+// Compares unescaping a quoted token into a std::string and calling to_enum()
+// with to_enum_from_quoted(), which finds the closing quote and unescapes
+// while hashing. Tokens are escape-free or have one escape (a \u sequence in
+// place of the first byte), as JSON writers that escape aggressively emit
+// them. Inputs are JSON arrays of tokens, so each lookup also has to find
+// where its token ends.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/quoted_bench.cpp -o quoted_bench
+// Usage: quoted_bench [--quick]
+
+#include <cstring>
+#include <memory>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t INPUTS = 4096;
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+/**
+ * @brief Quotes a key for JSON, writing its first byte as a \u escape if asked to.
+ */
+std::string quote(std::string_view key, bool escaped) {
+    std::string out = "\"";
+    for (std::size_t i = 0; i < key.size(); i++) {
+        if (escaped && i == 0) {
+            char buffer[8];
+            std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned char>(key[i]));
+            out += buffer;
+        } else {
+            out += key[i];
+        }
+    }
+    return out + "\"";
+}
+
+/**
+ * @brief The usual reader: unescape into a reused string, then look the copy up.
+ */
+template<typename Table>
+std::pair<Key, std::size_t> unescape_then_lookup(const Table& table, const char* p, const char* end,
+                                                 std::string& scratch) {
+    scratch.clear();
+    const char* after = unescape_quoted(p, end, QuoteStyle::Json, [&scratch](std::string_view piece) { scratch.append(piece); });
+    return {table.to_enum(scratch), static_cast<std::size_t>(after - p)};
+}
+
+template<std::size_t N>
+void run_size(KeyShape shape, Distribution dist, std::mt19937_64& rng) {
+    std::vector<std::string> keys = make_keys(shape, N, rng);
+    auto table = std::make_unique<EnumString<Key, N>>(make_table<N>(keys));
+    std::vector<uint32_t> indices = make_indices(dist, N, INPUTS, rng);
+
+    for (bool escaped : {false, true}) {
+        // One buffer per input holding the rest of the array, like a reader positioned on a token.
+        std::vector<std::string> inputs(INPUTS);
+        for (std::size_t i = 0; i < INPUTS; i++) {
+            inputs[i] = quote(keys[indices[i]], escaped) + ",\"" + keys[indices[(i + 1) % INPUTS]] + "\"]";
+        }
+        std::string scratch;
+        Result copy = measure(INPUTS, [&](std::size_t i) {
+            const std::string& in = inputs[i];
+            do_not_optimize(unescape_then_lookup(*table, in.data(), in.data() + in.size(), scratch));
+        }, g_min_time);
+        Result direct = measure(INPUTS, [&](std::size_t i) {
+            const std::string& in = inputs[i];
+            do_not_optimize(table->to_enum_from_quoted(in.data(), in.data() + in.size()).value);
+        }, g_min_time);
+        std::printf("%-7s %-8s %6zu %-8s %-14s %10.2f %10.2f %+9.1f%%\n", shape_name(shape), distribution_name(dist), N,
+                    escaped ? "escaped" : "plain", engine_name(table->engine()).data(), copy.ns_per_op,
+                    direct.ns_per_op, (direct.ns_per_op / copy.ns_per_op - 1.0) * 100);
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    if (quick) {
+        g_min_time = std::chrono::milliseconds(2);
+    }
+
+    std::mt19937_64 rng(47);
+    std::printf("%-7s %-8s %6s %-8s %-14s %10s %10s %10s\n", "keys", "dist", "N", "tokens", "engine", "copy",
+                "quoted", "change");
+    for (KeyShape shape : ALL_SHAPES) {
+        for (Distribution dist : ALL_DISTRIBUTIONS) {
+            run_size<8>(shape, dist, rng);
+            run_size<256>(shape, dist, rng);
+            if (!quick) {
+                run_size<4096>(shape, dist, rng);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,138 @@
+// Finding enum names in free text.
+//
+// Scans generated log lines of about 120 bytes for every occurrence of the
+// names of a table, with one name per line on average. The usual scanner
+// calls std::string_view::find for each name in turn until it finds no more,
+// which reads every line once per name. NameScanner finds all of them in one
+// pass with an Aho-Corasick automaton, skipping with SSE2 to the rare bytes
+// of the names while it is not inside a possible occurrence; "rare" is the
+// number of bytes the prefilter looks for, 0 where there are too many. Two
+// tables are timed, 16 event names and 3 log levels. The ASCII-insensitive
+// variant is timed too, against finds on a lower-cased copy of the line. The tables are compile-time constants, as NameScanner needs.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/scan_bench.cpp -o scan_bench
+// Usage: scan_bench [--quick]
+
+#include <cstring>
+
+#include <Topname/NameScanner.hpp>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t INPUTS = 1024;
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+enum class Event : uint8_t {};
+enum class Level : uint8_t { Error, Warn, Fatal };
+
+constexpr auto event_names = EnumString(
+    Event{0}, "timeout", Event{1}, "refused", Event{2}, "reset", Event{3}, "denied", Event{4}, "panic",
+    Event{5}, "oom", Event{6}, "retry", Event{7}, "deadlock", Event{8}, "corrupt", Event{9}, "overflow",
+    Event{10}, "segfault", Event{11}, "throttled", Event{12}, "evicted", Event{13}, "unreachable",
+    Event{14}, "expired", Event{15}, "rejected");
+
+constexpr auto level_names = EnumString(Level::Error, "error", Level::Warn, "warn", Level::Fatal, "fatal");
+
+constexpr std::array<std::string_view, 16> FILLER{
+    "request", "served", "user", "id", "path", "/api/v1/items", "status", "200", "in", "ms",
+    "from", "host", "node-7", "queue", "depth", "ok"};
+
+/**
+ * @brief The usual scanner: one find() loop per name.
+ */
+template<const auto& Table>
+std::size_t find_per_name(std::string_view line) {
+    std::size_t count = 0;
+    Table.for_each_pair([&count, line](auto value, std::string_view name) {
+        for (std::size_t at = line.find(name); at != std::string_view::npos; at = line.find(name, at + 1)) {
+            do_not_optimize(value);
+            count++;
+        }
+    });
+    return count;
+}
+
+/**
+ * @brief Counts the occurrences of the names of a table in a line with NameScanner.
+ */
+template<const auto& Table, MatchCase Case>
+std::size_t scan_line(std::string_view line) {
+    static constexpr NameScanner<Table, Case> scanner;
+    std::size_t count = 0;
+    scanner.for_each_match(line, [&count](std::size_t, auto value) {
+        do_not_optimize(value);
+        count++;
+    });
+    return count;
+}
+
+template<const auto& Table>
+void run_table(const char* label, std::mt19937_64& rng) {
+    std::vector<std::string> names;
+    Table.for_each_pair([&names](auto, std::string_view name) { names.emplace_back(name); });
+
+    std::vector<std::string> lines(INPUTS);
+    std::vector<std::string> shouted(INPUTS);
+    std::size_t bytes = 0;
+    for (std::size_t i = 0; i < INPUTS; i++) {
+        std::string& line = lines[i];
+        while (line.size() < 120) {
+            line += rng() % 16 == 0 ? names[rng() % names.size()] : std::string(FILLER[rng() % FILLER.size()]);
+            line += ' ';
+        }
+        bytes += line.size();
+        shouted[i] = line;
+        for (char& ch : shouted[i]) {
+            ch = rng() % 2 == 0 && ch >= 'a' && ch <= 'z' ? static_cast<char>(ch - 'a' + 'A') : ch;
+        }
+    }
+
+    Result finds = measure(INPUTS, [&](std::size_t i) {
+        do_not_optimize(find_per_name<Table>(lines[i]));
+    }, g_min_time);
+    Result scan = measure(INPUTS, [&](std::size_t i) {
+        do_not_optimize(scan_line<Table, MatchCase::Sensitive>(lines[i]));
+    }, g_min_time);
+    std::string lowered;
+    Result lower_finds = measure(INPUTS, [&](std::size_t i) {
+        lowered = shouted[i];
+        for (char& ch : lowered) {
+            ch = ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch;
+        }
+        do_not_optimize(find_per_name<Table>(lowered));
+    }, g_min_time);
+    Result scan_insensitive = measure(INPUTS, [&](std::size_t i) {
+        do_not_optimize(scan_line<Table, MatchCase::AsciiInsensitive>(shouted[i]));
+    }, g_min_time);
+
+    double per_line = static_cast<double>(bytes) / INPUTS;
+    auto print = [&](const char* variant, std::size_t rare, const Result& find, const Result& scanned) {
+        std::printf("%-8s %6zu %-12s %6zu %10.2f %10.2f %9.2f %9.2f\n", label, names.size(), variant, rare,
+                    find.ns_per_op, scanned.ns_per_op, per_line / find.ns_per_op, per_line / scanned.ns_per_op);
+    };
+    print("sensitive", NameScanner<Table, MatchCase::Sensitive>::prefilter_bytes(), finds, scan);
+    print("insensitive", NameScanner<Table, MatchCase::AsciiInsensitive>::prefilter_bytes(), lower_finds,
+          scan_insensitive);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    if (quick) {
+        g_min_time = std::chrono::milliseconds(2);
+    }
+
+    std::mt19937_64 rng(50);
+    std::printf("%-8s %6s %-12s %6s %10s %10s %9s %9s\n", "table", "names", "case", "rare", "find", "scan",
+                "GB/s find", "GB/s scan");
+    run_table<event_names>("events", rng);
+    run_table<level_names>("levels", rng);
+    return 0;
+}
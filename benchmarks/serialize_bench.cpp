@@ -0,0 +1,124 @@
+// Bulk export of enum columns as delimited text and JSON.
+//
+// Writes columns of COLUMN enum values separated by ','. Text rows append
+// to_string() and the delimiter to a reserved std::string one value at a
+// time, and compare that with NameSerializer::write_names() into a
+// preallocated buffer. JSON rows quote and escape every to_string() result at
+// runtime, and compare that with NameSerializer::write_json(), which copies
+// fragments escaped in advance. Reports ns per value and output GB/s for
+// uniform and Zipf columns.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/serialize_bench.cpp -o serialize_bench
+// Usage: serialize_bench [--quick]
+
+#include <cstring>
+#include <memory>
+
+#include <Topname/NameSerializer.hpp>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t COLUMN = 4096;
+constexpr std::size_t COLUMNS = 8;
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+template<std::size_t N>
+void run_size(KeyShape shape, Distribution dist, std::mt19937_64& rng) {
+    std::vector<std::string> keys = make_keys(shape, N, rng);
+    auto table = std::make_unique<EnumString<Key, N>>(make_table<N>(keys));
+    NameSerializer<Key> names(*table);
+
+    std::vector<std::vector<Key>> columns(COLUMNS);
+    std::size_t bytes = 0;
+    for (auto& column : columns) {
+        for (uint32_t index : make_indices(dist, N, COLUMN, rng)) {
+            column.push_back(static_cast<Key>(index));
+        }
+        bytes += names.formatted_size(column, ',');
+    }
+    std::vector<char> buffer(bytes / COLUMNS * 4);
+    std::string appended;
+    auto print = [&](const char* format, std::size_t column_bytes, const Result& naive, const Result& bulk) {
+        double per_column = static_cast<double>(column_bytes) / COLUMNS;
+        std::printf("%-7s %-8s %6zu %-6s %8.1f %10.2f %10.2f %9.2f %9.2f\n", shape_name(shape),
+                    distribution_name(dist), N, format, per_column / COLUMN, naive.ns_per_op / COLUMN,
+                    bulk.ns_per_op / COLUMN, per_column / naive.ns_per_op, per_column / bulk.ns_per_op);
+    };
+
+    Result append = measure(COLUMNS, [&](std::size_t c) {
+        appended.clear();
+        appended.reserve(buffer.size());
+        for (Key value : columns[c]) {
+            appended.append(table->to_string(value));
+            appended.push_back(',');
+        }
+        appended.pop_back();
+        do_not_optimize(appended.data());
+    }, g_min_time);
+    Result write = measure(COLUMNS, [&](std::size_t c) {
+        do_not_optimize(names.write_names(columns[c], ',', buffer));
+        do_not_optimize(buffer.data());
+    }, g_min_time);
+    print("text", bytes, append, write);
+
+    std::size_t json_bytes = 0;
+    for (const auto& column : columns) {
+        json_bytes += names.json_size(column, ',');
+    }
+    Result escape = measure(COLUMNS, [&](std::size_t c) {
+        appended.clear();
+        appended.reserve(buffer.size());
+        for (Key value : columns[c]) {
+            appended.push_back('"');
+            for (char ch : table->to_string(value)) {
+                if (ch == '"' || ch == '\\') {
+                    appended.push_back('\\');
+                } else if (static_cast<unsigned char>(ch) < 0x20) {
+                    char escape[7];
+                    std::snprintf(escape, sizeof(escape), "\\u%04x", static_cast<unsigned>(ch));
+                    appended.append(escape);
+                    continue;
+                }
+                appended.push_back(ch);
+            }
+            appended.push_back('"');
+            appended.push_back(',');
+        }
+        appended.pop_back();
+        do_not_optimize(appended.data());
+    }, g_min_time);
+    Result write_json = measure(COLUMNS, [&](std::size_t c) {
+        do_not_optimize(names.write_json(columns[c], ',', buffer));
+        do_not_optimize(buffer.data());
+    }, g_min_time);
+    print("json", json_bytes, escape, write_json);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    if (quick) {
+        g_min_time = std::chrono::milliseconds(2);
+    }
+
+    std::mt19937_64 rng(31);
+    std::printf("%-7s %-8s %6s %-6s %8s %10s %10s %9s %9s\n", "keys", "dist", "N", "format", "B/value", "naive",
+                "bulk", "GB/s nai", "GB/s bulk");
+    for (KeyShape shape : ALL_SHAPES) {
+        for (Distribution dist : ALL_DISTRIBUTIONS) {
+            run_size<16>(shape, dist, rng);
+            run_size<256>(shape, dist, rng);
+            if (!quick) {
+                run_size<4096>(shape, dist, rng);
+            }
+        }
+    }
+    return 0;
+}
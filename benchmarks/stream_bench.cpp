@@ -0,0 +1,102 @@
+// Matching tokens that arrive split across buffers.
+//
+// Every token, an HTTP header name, is cut at a random point into two
+// chunks, as network reads cut them. The usual reader appends the chunks to
+// a reused std::string and calls try_to_enum() once the token is complete;
+// StreamMatcher is fed each chunk where it lies. Inputs are all known names,
+// or half of them with "-x" inserted somewhere, which StreamMatcher rejects
+// at the first byte that rules them out. The table is a compile-time
+// constant, as StreamMatcher needs, so only its 40 names are measured.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude benchmarks/stream_bench.cpp -o stream_bench
+// Usage: stream_bench [--quick]
+
+#include <cstring>
+
+#include <Topname/StreamMatcher.hpp>
+
+#include "bench_common.hpp"
+
+using namespace Topname;
+using namespace Topname::bench;
+
+namespace {
+
+constexpr std::size_t INPUTS = 4096;
+
+std::chrono::nanoseconds g_min_time = std::chrono::milliseconds(20);
+
+enum class Header : uint8_t {};
+
+constexpr auto header_names = EnumString(
+    Header{0}, "accept", Header{1}, "accept-charset", Header{2}, "accept-encoding", Header{3}, "accept-language",
+    Header{4}, "accept-ranges", Header{5}, "access-control-allow-origin", Header{6}, "age", Header{7}, "allow",
+    Header{8}, "authorization", Header{9}, "cache-control", Header{10}, "connection", Header{11}, "content-disposition",
+    Header{12}, "content-encoding", Header{13}, "content-language", Header{14}, "content-length",
+    Header{15}, "content-location", Header{16}, "content-range", Header{17}, "content-type", Header{18}, "cookie",
+    Header{19}, "date", Header{20}, "etag", Header{21}, "expect", Header{22}, "expires", Header{23}, "from",
+    Header{24}, "host", Header{25}, "if-match", Header{26}, "if-modified-since", Header{27}, "if-none-match",
+    Header{28}, "if-range", Header{29}, "if-unmodified-since", Header{30}, "last-modified", Header{31}, "link",
+    Header{32}, "location", Header{33}, "max-forwards", Header{34}, "proxy-authenticate", Header{35}, "range",
+    Header{36}, "referer", Header{37}, "retry-after", Header{38}, "server", Header{39}, "set-cookie");
+
+struct Token {
+    std::string bytes;
+    std::size_t split;
+};
+
+void run(const char* label, const std::vector<Token>& tokens) {
+    std::string scratch;
+    Result reassemble = measure(INPUTS, [&](std::size_t i) {
+        const Token& token = tokens[i];
+        std::string_view bytes = token.bytes;
+        scratch.assign(bytes.substr(0, token.split));
+        scratch.append(bytes.substr(token.split));
+        do_not_optimize(header_names.try_to_enum(scratch));
+    }, g_min_time);
+    Result stream = measure(INPUTS, [&](std::size_t i) {
+        const Token& token = tokens[i];
+        std::span<const char> bytes(token.bytes);
+        StreamMatcher<header_names> matcher;
+        if (matcher.feed(bytes.first(token.split)) != StreamStatus::NoMatch) {
+            matcher.feed(bytes.subspan(token.split));
+        }
+        do_not_optimize(matcher.finish());
+    }, g_min_time);
+    std::printf("%-12s %10.2f %10.2f %+9.1f%%\n", label, reassemble.ns_per_op, stream.ns_per_op,
+                (stream.ns_per_op / reassemble.ns_per_op - 1.0) * 100);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool quick = argc > 1 && std::strcmp(argv[1], "--quick") == 0;
+    if (quick) {
+        g_min_time = std::chrono::milliseconds(2);
+    }
+
+    std::vector<std::string> names;
+    header_names.for_each_pair([&names](Header, std::string_view name) { names.emplace_back(name); });
+
+    std::mt19937_64 rng(49);
+    std::printf("StreamMatcher<header_names>: %zu states, %zu byte classes, %zu table bytes\n",
+                StreamMatcher<header_names>::STATES, StreamMatcher<header_names>::CLASSES,
+                StreamMatcher<header_names>::table_bytes());
+    std::printf("%-12s %10s %10s %10s\n", "inputs", "reassemble", "stream", "change");
+    for (Distribution dist : ALL_DISTRIBUTIONS) {
+        std::vector<uint32_t> indices = make_indices(dist, names.size(), INPUTS, rng);
+        for (bool unknown : {false, true}) {
+            std::vector<Token> tokens;
+            for (std::size_t i = 0; i < INPUTS; i++) {
+                std::string bytes = names[indices[i]];
+                if (unknown && i % 2 == 1) {
+                    bytes.insert(rng() % (bytes.size() + 1), "-x");
+                }
+                tokens.push_back({bytes, static_cast<std::size_t>(rng() % (bytes.size() + 1))});
+            }
+            std::string label = std::string(distribution_name(dist)) + (unknown ? "/50%" : "");
+            run(label.c_str(), tokens);
+        }
+    }
+    return 0;
+}
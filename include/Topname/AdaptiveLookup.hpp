@@ -0,0 +1,335 @@
+#ifndef TOPNAME_ADAPTIVE_LOOKUP_H
+#define TOPNAME_ADAPTIVE_LOOKUP_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#include "Topname.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TOPNAME_COLD __attribute__((noinline, cold))
+#define TOPNAME_NOINLINE __attribute__((noinline))
+#else
+#define TOPNAME_COLD
+#define TOPNAME_NOINLINE
+#endif
+
+namespace Topname {
+
+/**
+ * @brief The paths AdaptiveEnumString can route string lookups through.
+ */
+enum class AdaptiveMode {
+    DirectProbe,    /**< Look the string up right away. */
+    PrefilterFirst, /**< Reject strings the table can not contain before looking them up. */
+};
+
+/**
+ * @brief Figures of the traffic observed by an AdaptiveEnumString.
+ */
+struct AdaptiveStats {
+    AdaptiveMode mode;
+    uint64_t switches;        /**< Mode changes so far. */
+    double miss_rate;         /**< Share of misses in the last completed window. */
+    double rejected_rate;     /**< Share of lookups the prefilter rejected in that window. */
+    double average_length;    /**< Average length of the sampled misses in that window. */
+};
+
+/**
+ * @brief An EnumString whose to_enum() adapts to the share of unknown strings.
+ *
+ * Under mostly-hit traffic every lookup goes straight to the engine of the
+ * table. When many lookups miss, e.g. while clients send names from a newer
+ * version during a rollout, a prefilter rejects most of them before any
+ * hashing or scanning. It checks the length and then a set of SIGNATURE_BITS
+ * hashed (length, first byte, last two bytes) signatures of the mapped
+ * strings. The prefilter has no false negatives, and the engines compare the
+ * string they find, so both modes give the same result for every string,
+ * including unknown ones whose hash collides with a mapped one.
+ *
+ * One lookup in SAMPLE_PERIOD per thread and table is sampled: it evaluates
+ * both paths and records whether the string hit, whether the prefilter would
+ * have rejected it and its length. After WINDOW samples the expected saving of the
+ * prefilter, from the rejected share and the engine's miss cost under
+ * DEFAULT_ENGINE_COST_MODEL, is compared to its cost. The mode flips to
+ * PrefilterFirst above ENTER_RATIO times the cost and back below EXIT_RATIO
+ * times the cost, so traffic near the break-even point does not flap.
+ *
+ * Each table keeps its countdown in one of THREAD_SLOTS per-thread slots, so
+ * tables adapt independently. In DirectProbe mode unsampled lookups pay a
+ * check of the slot's owner, the countdown and one branch; the mode is only
+ * read on the sampled path. In PrefilterFirst mode every lookup takes one
+ * out-of-line call that applies the prefilter. Slots are handed out
+ * round-robin at construction, so two live tables of one type share a slot
+ * only if THREAD_SLOTS others were constructed in between; lookups
+ * alternating between them stay correct but are sampled less.
+ *
+ * @tparam E Enum type.
+ * @tparam N The number of mappings.
+ * @tparam I The instrumentation policy of the table.
+ */
+template<EnumType E, std::size_t N, typename I = NoInstrumentation>
+class AdaptiveEnumString {
+public:
+    static constexpr uint32_t SAMPLE_PERIOD = 64;
+    static constexpr uint32_t WINDOW = 256;
+    /** @brief Per-thread sampling slots shared by the tables of one type, assigned round-robin. */
+    static constexpr std::size_t THREAD_SLOTS = 64;
+    static constexpr double PREFILTER_COST = 1.5; /**< ns per lookup, as the cost model. */
+    static constexpr double ENTER_RATIO = 1.5;
+    static constexpr double EXIT_RATIO = 0.75;
+    /** @brief Bits of the prefilter's signature set: about 16 per mapping, at least 512. */
+    static constexpr std::size_t SIGNATURE_BITS = std::bit_ceil(std::max<std::size_t>(512, N * 16));
+
+    /**
+     * @brief Wraps a copy of a table.
+     *
+     * @param table The table to serve lookups from.
+     */
+    explicit AdaptiveEnumString(const EnumString<E, N, I>& table)
+    : m_table(table)
+    {
+        m_table.for_each_string([this](std::string_view str) {
+            m_lengths |= length_bit(str.size());
+            std::size_t sig = signature(str);
+            m_signatures[sig / 64] |= uint64_t{1} << (sig % 64);
+        });
+        m_miss_fixed = miss_fixed_cost();
+    }
+
+    AdaptiveEnumString(const AdaptiveEnumString&) = delete;
+    AdaptiveEnumString& operator=(const AdaptiveEnumString&) = delete;
+
+    /**
+     * @brief Converts a string to its corresponding enum value without throwing.
+     *
+     * @param value The string to convert.
+     * @return The corresponding enum value, or std::nullopt if the string is not mapped.
+     */
+    [[nodiscard]] std::optional<E> try_to_enum(std::string_view value) const {
+        Route route = Route::Probe;
+        ThreadSlot& slot = t_slots[m_slot];
+        if (slot.owner != this || --slot.countdown == 0) [[unlikely]] {
+            route = next_route(slot, value);
+            if (route == Route::Reject) {
+                return std::nullopt;
+            }
+        }
+        // One lookup for every route, so its result is not merged with another call's through memory.
+        std::optional<E> found = m_table.try_to_enum(value);
+        if (route == Route::Sample) [[unlikely]] {
+            record_sample(value, found.has_value());
+        }
+        return found;
+    }
+
+    /**
+     * @brief Converts a string to its corresponding enum value.
+     *
+     * @param value The string to convert.
+     * @return The corresponding enum value.
+     * @throw InvalidStringValue If the string does not match any enum value.
+     */
+    [[nodiscard]] E to_enum(std::string_view value) const {
+        if (std::optional<E> found = try_to_enum(value)) {
+            return *found;
+        }
+        auto err = EnumStringException::ErrorCode::InvalidStringValue;
+        throw EnumStringException(err, "String value not found in the mapping");
+    }
+
+    /**
+     * @brief Returns true if the prefilter proves that the table does not contain a string.
+     */
+    [[nodiscard]] bool rejects(std::string_view value) const noexcept {
+        if ((m_lengths & length_bit(value.size())) == 0) {
+            return true;
+        }
+        std::size_t sig = signature(value);
+        return (m_signatures[sig / 64] & (uint64_t{1} << (sig % 64))) == 0;
+    }
+
+    /**
+     * @brief Returns the path currently taken by unsampled lookups.
+     */
+    [[nodiscard]] AdaptiveMode mode() const noexcept { return m_mode.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the traffic figures behind the current mode.
+     */
+    [[nodiscard]] AdaptiveStats stats() const noexcept {
+        return {mode(), m_switches.load(std::memory_order_relaxed),
+                m_last_miss_rate.load(std::memory_order_relaxed),
+                m_last_rejected_rate.load(std::memory_order_relaxed),
+                m_last_length.load(std::memory_order_relaxed)};
+    }
+
+    /**
+     * @brief Returns the wrapped table, e.g. for to_string().
+     */
+    [[nodiscard]] const EnumString<E, N, I>& table() const noexcept { return m_table; }
+
+private:
+    EnumString<E, N, I> m_table;
+    uint64_t m_lengths = 0;                 /**< Bit L for length L < 63, bit 63 for longer strings. */
+    std::array<uint64_t, SIGNATURE_BITS / 64> m_signatures{}; /**< Set of (length, first, last two bytes) signatures. */
+    double m_miss_fixed = 0.0;              /**< Length-independent cost of a miss without the prefilter. */
+
+    mutable std::atomic<AdaptiveMode> m_mode{AdaptiveMode::DirectProbe};
+    mutable std::atomic<uint64_t> m_switches{0};
+
+    // Current window, written by sampled lookups only.
+    mutable std::atomic<uint32_t> m_samples{0};
+    mutable std::atomic<uint32_t> m_misses{0};
+    mutable std::atomic<uint32_t> m_rejected{0};
+    mutable std::atomic<uint64_t> m_miss_bytes{0};
+
+    // Last completed window, for stats().
+    mutable std::atomic<double> m_last_miss_rate{0.0};
+    mutable std::atomic<double> m_last_rejected_rate{0.0};
+    mutable std::atomic<double> m_last_length{0.0};
+
+    /**
+     * @brief The sampling state of one table on one thread.
+     */
+    struct ThreadSlot {
+        const AdaptiveEnumString* owner = nullptr;
+        uint32_t countdown = 0;    /**< Lookups left before next_route(). */
+        uint32_t since_sample = 0; /**< Lookups since the last sample. */
+    };
+
+    static inline std::atomic<uint32_t> s_next_slot{0};
+    static inline constinit thread_local std::array<ThreadSlot, THREAD_SLOTS> t_slots{};
+
+    const uint32_t m_slot = s_next_slot.fetch_add(1, std::memory_order_relaxed) % THREAD_SLOTS;
+
+    static constexpr uint64_t length_bit(std::size_t length) noexcept {
+        return uint64_t{1} << std::min<std::size_t>(length, 63);
+    }
+
+    static constexpr std::size_t signature(std::string_view str) noexcept {
+        if (str.empty()) {
+            return 0;
+        }
+        // The last two bytes tell apart strings that share a long prefix, e.g. ERROR_..._1 and ERROR_..._2.
+        uint32_t key = static_cast<uint32_t>(str.size() & 0xff)
+                     | static_cast<uint32_t>(static_cast<unsigned char>(str.front())) << 8
+                     | static_cast<uint32_t>(static_cast<unsigned char>(str[str.size() - std::min<std::size_t>(str.size(), 2)])) << 16
+                     | static_cast<uint32_t>(static_cast<unsigned char>(str.back())) << 24;
+        return mix_hash(key) & (SIGNATURE_BITS - 1);
+    }
+
+    /**
+     * @brief Cost of a miss that does not depend on the length of the input, under the default model.
+     */
+    double miss_fixed_cost() const noexcept {
+        const EngineCostModel& model = DEFAULT_ENGINE_COST_MODEL;
+        switch (m_table.engine()) {
+            case Engine::LinearScan: return model.scan_fixed + model.scan_entry * static_cast<double>(N);
+            case Engine::PerfectHash: return model.perfect_fixed;
+            // An unsuccessful search of a half-full linear probing table inspects 2.5 slots on average.
+            default: return model.hash_fixed + model.probe * 2.5;
+        }
+    }
+
+    /**
+     * @brief What try_to_enum() does with a lookup the countdown singled out.
+     */
+    enum class Route : uint8_t {
+        Probe,  /**< Look the string up. */
+        Reject, /**< The prefilter proved it a miss. */
+        Sample, /**< Look the string up and record it in the window. */
+    };
+
+    /**
+     * @brief Routes the lookups the countdown sends here: one in SAMPLE_PERIOD in DirectProbe mode, all
+     *        of them in PrefilterFirst mode.
+     *
+     * Keeping the mode out of the countdown leaves the unsampled path one decrement and one branch. A
+     * slot another table holds is taken over here with a fresh count.
+     */
+    TOPNAME_NOINLINE Route next_route(ThreadSlot& slot, std::string_view value) const {
+        if (slot.owner != this) {
+            slot.owner = this;
+            slot.since_sample = 0;
+        }
+        Route route = Route::Probe;
+        bool rejected = rejects(value);
+        if (++slot.since_sample >= SAMPLE_PERIOD) {
+            slot.since_sample = 0;
+            route = Route::Sample;
+            if (rejected) {
+                m_rejected.fetch_add(1, std::memory_order_relaxed);
+            }
+        } else if (rejected && m_mode.load(std::memory_order_relaxed) == AdaptiveMode::PrefilterFirst) {
+            route = Route::Reject;
+        }
+        if (m_mode.load(std::memory_order_relaxed) == AdaptiveMode::PrefilterFirst) {
+            slot.countdown = 1;
+        } else {
+            // The lookups the countdown lets through until the next sample count towards it.
+            slot.countdown = SAMPLE_PERIOD - slot.since_sample;
+            slot.since_sample = SAMPLE_PERIOD - 1;
+        }
+        return route;
+    }
+
+    TOPNAME_COLD void record_sample(std::string_view value, bool hit) const {
+        if (!hit) {
+            m_misses.fetch_add(1, std::memory_order_relaxed);
+            m_miss_bytes.fetch_add(value.size(), std::memory_order_relaxed);
+        }
+        if (m_samples.fetch_add(1, std::memory_order_relaxed) + 1 == WINDOW) {
+            close_window();
+        }
+    }
+
+    /**
+     * @brief Decides the mode from the completed window and starts a new one.
+     */
+    void close_window() const {
+        double samples = static_cast<double>(m_samples.exchange(0, std::memory_order_relaxed));
+        double misses = static_cast<double>(m_misses.exchange(0, std::memory_order_relaxed));
+        double rejected = static_cast<double>(m_rejected.exchange(0, std::memory_order_relaxed));
+        double bytes = static_cast<double>(m_miss_bytes.exchange(0, std::memory_order_relaxed));
+        if (samples == 0) {
+            return;
+        }
+
+        double average_length = misses > 0 ? bytes / misses : 0.0;
+        double miss_cost = m_miss_fixed;
+        if (m_table.engine() != Engine::LinearScan) {
+            miss_cost += DEFAULT_ENGINE_COST_MODEL.hash_byte * average_length;
+        }
+        double saving = rejected / samples * miss_cost;
+        m_last_miss_rate.store(misses / samples, std::memory_order_relaxed);
+        m_last_rejected_rate.store(rejected / samples, std::memory_order_relaxed);
+        m_last_length.store(average_length, std::memory_order_relaxed);
+
+        AdaptiveMode current = m_mode.load(std::memory_order_relaxed);
+        AdaptiveMode next = current;
+        if (current == AdaptiveMode::DirectProbe && saving > ENTER_RATIO * PREFILTER_COST) {
+            next = AdaptiveMode::PrefilterFirst;
+        } else if (current == AdaptiveMode::PrefilterFirst && saving < EXIT_RATIO * PREFILTER_COST) {
+            next = AdaptiveMode::DirectProbe;
+        }
+        if (next != current && m_mode.compare_exchange_strong(current, next, std::memory_order_relaxed)) {
+            m_switches.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}; // class AdaptiveEnumString
+
+/**
+ * @brief Deduction guide to construct an AdaptiveEnumString from an EnumString.
+ */
+template<EnumType E, std::size_t N, typename I>
+AdaptiveEnumString(const EnumString<E, N, I>&) -> AdaptiveEnumString<E, N, I>;
+
+}; // namespace Topname
+
+#endif // TOPNAME_ADAPTIVE_LOOKUP_H
@@ -0,0 +1,227 @@
+#ifndef TOPNAME_COLUMN_DECODER_H
+#define TOPNAME_COLUMN_DECODER_H
+
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief The result of one ColumnDecoder::decode() call.
+ */
+struct ColumnBatch {
+    std::size_t rows = 0;     /**< Rows decoded, i.e. entries written to the codes. */
+    std::size_t consumed = 0; /**< Bytes of the text those rows take up, including their newlines. */
+    std::size_t errors = 0;   /**< Rows flagged in the error bitmap. */
+};
+
+/**
+ * @brief Decodes one enum column of delimited text, e.g. CSV or TSV, into an array of enum values.
+ *
+ * A single pass over the text replaces splitting rows into fields and then
+ * looking the fields up. The text is read in BLOCK-byte blocks, and with
+ * SSE2 each block is compared with the delimiter and '\n' 16 bytes at a
+ * time into one bit per byte. The set bits are walked with
+ * std::countr_zero, so the bytes between delimiters are never looked at
+ * one by one; only the field of the enum column is read, when the table
+ * looks it up in place in the text.
+ *
+ * Output is columnar: the value of row r goes to codes[r], and bit r % 64
+ * of errors[r / 64] is set if the field is not a string of the table or
+ * the row has too few fields, in which case codes[r] is E{}. For CRLF line
+ * ends, a '\r' before the newline, or before the end of the input, is dropped
+ * from the last field of the row; a '\r' in any other field is part of it.
+ * Quoted fields are not supported: a delimiter or newline inside quotes
+ * splits the field.
+ *
+ * Lookups go through try_to_enum() of the table and are reported to its
+ * instrumentation policy, once per decoded row: the field of a row that is
+ * cut off at the end of a chunk is only looked up when the row is complete.
+ *
+ * @code
+ * ColumnDecoder colors(color_names, 2); // the third column
+ * std::vector<Color> codes(rows);
+ * std::vector<uint64_t> errors((rows + 63) / 64);
+ * ColumnBatch batch = colors.decode(text, codes, errors, true);
+ * @endcode
+ *
+ * @tparam E Enum type.
+ * @tparam N The number of mappings.
+ * @tparam I The instrumentation policy of the table.
+ */
+template<EnumType E, std::size_t N, typename I = NoInstrumentation>
+class ColumnDecoder {
+public:
+    /** @brief Bytes classified per step of the scan, one bit each. */
+    static constexpr std::size_t BLOCK = 64;
+
+    /**
+     * @brief Wraps a copy of a table.
+     *
+     * @param table The strings of the column.
+     * @param column The zero-based index of the enum column in each row.
+     * @param delimiter The character between fields; may not be '\n'.
+     * @throw ParseError If the delimiter is '\n'.
+     */
+    ColumnDecoder(const EnumString<E, N, I>& table, std::size_t column, char delimiter = ',')
+    : m_table(table), m_column(column), m_delimiter(delimiter)
+    {
+        if (delimiter == '\n') {
+            auto err = EnumStringException::ErrorCode::ParseError;
+            throw EnumStringException(err, "The delimiter can not be a newline");
+        }
+    }
+
+    /**
+     * @brief Decodes the complete rows at the start of a text.
+     *
+     * Stops after the last newline, or earlier when the codes or the error
+     * bitmap are full; the caller passes the rest of the text again with
+     * the next chunk appended. At the end of the input, a last row without
+     * a newline is decoded as well if at_end is set. Error words are
+     * written whole, with bits past the last row cleared.
+     *
+     * @param text The rows.
+     * @param codes Receives the value of every row.
+     * @param errors Receives a bit per row, set for rows without a valid value.
+     * @param at_end Whether text ends the input.
+     * @return The rows decoded, the bytes they take up and the number of errors.
+     */
+    ColumnBatch decode(std::string_view text, std::span<E> codes, std::span<uint64_t> errors,
+                       bool at_end = false) const {
+        ColumnBatch batch;
+        const std::size_t capacity = std::min(codes.size(), errors.size() * 64);
+        if (capacity == 0) {
+            return batch;
+        }
+
+        // Locals rather than members: the stores to codes and errors would otherwise force reloads.
+        const char* const begin = text.data();
+        const char* const end = begin + text.size();
+        const char delimiter = m_delimiter;
+        const std::size_t column = m_column;
+        E* const out = codes.data();
+        std::size_t rows = 0;
+        std::size_t failed = 0;
+        uint64_t error_word = 0;
+        std::size_t field = 0;
+        const char* start = begin;   // Start of the current field.
+        const char* row_end = begin; // One past the newline of the last decoded row.
+        // The enum field of the current row, looked up only once the row is complete: a row cut off
+        // at the end of a chunk is passed again with the next one and must not be counted twice.
+        std::string_view value_field;
+        bool seen = false;
+
+        auto end_field = [&](const char* stop, bool last) {
+            if (field == column) {
+                if (last && stop != start && stop[-1] == '\r') {
+                    stop--;
+                }
+                value_field = std::string_view(start, static_cast<std::size_t>(stop - start));
+                seen = true;
+            }
+            field++;
+        };
+        auto end_row = [&](const char* next) {
+            std::optional<E> value = seen ? m_table.try_to_enum(value_field) : std::nullopt;
+            out[rows] = value ? *value : E{};
+            if (!value) {
+                error_word |= uint64_t{1} << (rows % 64);
+                failed++;
+            }
+            rows++;
+            if (rows % 64 == 0) {
+                errors[rows / 64 - 1] = error_word;
+                error_word = 0;
+            }
+            field = 0;
+            seen = false;
+            row_end = next;
+            return rows < capacity;
+        };
+
+        bool full = false;
+        for (const char* p = begin; !full && p != end;) {
+            std::size_t size = std::min<std::size_t>(static_cast<std::size_t>(end - p), BLOCK);
+            for (uint64_t mask = structural_mask(p, size, delimiter); mask != 0; mask &= mask - 1) {
+                const char* at = p + std::countr_zero(mask);
+                end_field(at, *at == '\n');
+                start = at + 1;
+                if (*at == '\n' && !end_row(at + 1)) {
+                    full = true;
+                    break;
+                }
+            }
+            p += size;
+        }
+        if (!full && at_end && row_end != end) {
+            end_field(end, true);
+            end_row(end);
+        }
+        if (rows % 64 != 0) {
+            errors[rows / 64] = error_word;
+        }
+        batch.rows = rows;
+        batch.consumed = static_cast<std::size_t>(row_end - begin);
+        batch.errors = failed;
+        return batch;
+    }
+
+    /**
+     * @brief Returns the index of the enum column.
+     */
+    [[nodiscard]] std::size_t column() const noexcept { return m_column; }
+
+    /**
+     * @brief Returns the wrapped table.
+     */
+    [[nodiscard]] const EnumString<E, N, I>& table() const noexcept { return m_table; }
+
+private:
+    EnumString<E, N, I> m_table;
+    std::size_t m_column;
+    char m_delimiter;
+
+    /**
+     * @brief Returns a bit per byte of a block of at most BLOCK bytes, set for the delimiter and '\n'.
+     */
+    static uint64_t structural_mask(const char* p, std::size_t size, char delimiter) noexcept {
+        uint64_t mask = 0;
+        std::size_t i = 0;
+#if defined(__SSE2__)
+        const __m128i newlines = _mm_set1_epi8('\n');
+        const __m128i delimiters = _mm_set1_epi8(delimiter);
+        for (; i + 16 <= size; i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            auto bits = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(bytes, newlines), _mm_cmpeq_epi8(bytes, delimiters))));
+            mask |= static_cast<uint64_t>(bits) << i;
+        }
+#endif
+        for (; i < size; i++) {
+            if (p[i] == '\n' || p[i] == delimiter) {
+                mask |= uint64_t{1} << i;
+            }
+        }
+        return mask;
+    }
+}; // class ColumnDecoder
+
+/**
+ * @brief Deduction guide to construct a ColumnDecoder from an EnumString.
+ */
+template<EnumType E, std::size_t N, typename I>
+ColumnDecoder(const EnumString<E, N, I>&, std::size_t, char = ',') -> ColumnDecoder<E, N, I>;
+
+}; // namespace Topname
+
+#endif // TOPNAME_COLUMN_DECODER_H
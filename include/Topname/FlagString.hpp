@@ -0,0 +1,339 @@
+#ifndef TOPNAME_FLAG_STRING_H
+#define TOPNAME_FLAG_STRING_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief What FlagString does with bits that have no name.
+ */
+enum class UnknownBits {
+    Throw,  /**< Formatting throws InvalidEnumValue, parsing an unknown name throws InvalidStringValue. */
+    Ignore, /**< Formatting drops them, parsing skips unknown names. */
+    AsHex,  /**< Formatting appends them as one "0x..." token, parsing accepts such tokens. */
+};
+
+/**
+ * @brief Formats and parses combinations of bitmask enum values as "A|B|C".
+ *
+ * Built from an EnumString whose values are flags. Every bit is given the
+ * first declared name of a value consisting of that bit alone, and a value
+ * of 0 names the empty mask; values of several bits (aliases such as
+ * ReadWrite) are accepted by parse() but never produced by formatting.
+ *
+ * Formatting walks the set bits with std::countr_zero, so it costs one step
+ * per set bit rather than per name, and formatted_size() computes the exact
+ * output length from the name lengths before anything is written. Parsing
+ * makes a single pass, looking every delimited token up with the table and
+ * OR-ing the results.
+ *
+ * @code
+ * constexpr auto perms = FlagString(EnumString(Perm::Read, "Read", Perm::Write, "Write", Perm::Exec, "Exec"));
+ * perms.to_string(Perm::Read | Perm::Exec); // "Read|Exec"
+ * perms.parse("Write|Read");                // Perm::Read | Perm::Write
+ * @endcode
+ *
+ * @tparam E Enum type, with an underlying type of at most 64 bits.
+ * @tparam N The number of mappings.
+ * @tparam I The instrumentation policy of the table.
+ */
+template<EnumType E, std::size_t N, typename I = NoInstrumentation>
+class FlagString {
+    static_assert(sizeof(E) <= sizeof(uint64_t), "FlagString supports at most 64 bits");
+
+public:
+    static constexpr std::size_t BITS = sizeof(E) * 8;
+
+    /**
+     * @brief Builds the per-bit names of a table.
+     *
+     * @param table The names of the flags.
+     * @param policy What to do with bits without a name.
+     * @param delimiter The character between names.
+     */
+    constexpr explicit FlagString(const EnumString<E, N, I>& table, UnknownBits policy = UnknownBits::Throw,
+                                  char delimiter = '|')
+    : m_table(table), m_policy(policy), m_delimiter(delimiter)
+    {
+        bool has_zero = false;
+        m_table.for_each_pair([this, &has_zero](E enum_val, std::string_view str_val) {
+            uint64_t bits = to_bits(enum_val);
+            if (bits == 0) {
+                if (!has_zero) {
+                    m_zero_name = str_val;
+                    has_zero = true;
+                }
+            } else if (std::has_single_bit(bits) && (m_known & bits) == 0) {
+                m_names[std::countr_zero(bits)] = str_val;
+                m_known |= bits;
+            }
+        });
+    }
+
+    /**
+     * @brief Returns the exact number of characters to_string() and copy_to() produce for a mask.
+     *
+     * @throw InvalidEnumValue If the mask has bits without a name and the policy is UnknownBits::Throw.
+     */
+    [[nodiscard]] constexpr std::size_t formatted_size(E mask) const {
+        uint64_t bits = to_bits(mask);
+        uint64_t unknown = checked_unknown(bits);
+        bits &= m_known;
+        if (bits == 0 && unknown == 0) {
+            return m_zero_name.size();
+        }
+        std::size_t size = 0;
+        std::size_t tokens = 0;
+        for (uint64_t rest = bits; rest != 0; rest &= rest - 1) {
+            size += m_names[std::countr_zero(rest)].size();
+            tokens++;
+        }
+        if (unknown != 0) {
+            size += hex_size(unknown);
+            tokens++;
+        }
+        return size + tokens - 1;
+    }
+
+    /**
+     * @brief Returns the longest output of to_string(), for sizing a reusable buffer.
+     */
+    [[nodiscard]] constexpr std::size_t max_formatted_size() const noexcept {
+        std::size_t size = 0;
+        std::size_t tokens = 0;
+        for (uint64_t rest = m_known; rest != 0; rest &= rest - 1) {
+            size += m_names[std::countr_zero(rest)].size();
+            tokens++;
+        }
+        if (m_policy == UnknownBits::AsHex && m_known != all_bits()) {
+            size += hex_size(all_bits() & ~m_known);
+            tokens++;
+        }
+        return tokens == 0 ? m_zero_name.size() : std::max(size + tokens - 1, m_zero_name.size());
+    }
+
+    /**
+     * @brief Writes the names of the set bits of a mask into a caller buffer.
+     *
+     * Names follow bit order, lowest first. The empty mask is written as the
+     * name of the value 0, or as nothing if there is none.
+     *
+     * @param mask The combination of flags to format.
+     * @param out Destination with room for at least formatted_size(mask) characters.
+     * @return The number of characters written; no terminator is appended.
+     * @throw InvalidEnumValue If the mask has bits without a name and the policy is UnknownBits::Throw.
+     */
+    constexpr std::size_t copy_to(E mask, char* out) const {
+        uint64_t bits = to_bits(mask);
+        uint64_t unknown = checked_unknown(bits);
+        bits &= m_known;
+        if (bits == 0 && unknown == 0) {
+            std::copy_n(m_zero_name.data(), m_zero_name.size(), out);
+            return m_zero_name.size();
+        }
+        // The delimiter goes before every token but the first, so exactly formatted_size(mask) bytes are written.
+        char* p = out;
+        bool first = true;
+        for (uint64_t rest = bits; rest != 0; rest &= rest - 1) {
+            if (!first) {
+                *p++ = m_delimiter;
+            }
+            first = false;
+            std::string_view name = m_names[std::countr_zero(rest)];
+            p = std::copy_n(name.data(), name.size(), p);
+        }
+        if (unknown != 0) {
+            if (!first) {
+                *p++ = m_delimiter;
+            }
+            p = write_hex(unknown, p);
+        }
+        return static_cast<std::size_t>(p - out);
+    }
+
+    /**
+     * @brief Formats a mask into a string allocated once at its exact size.
+     *
+     * @throw InvalidEnumValue If the mask has bits without a name and the policy is UnknownBits::Throw.
+     */
+    [[nodiscard]] std::string to_string(E mask) const {
+        std::string out(formatted_size(mask), '\0');
+        copy_to(mask, out.data());
+        return out;
+    }
+
+    /**
+     * @brief Parses delimited names into a mask.
+     *
+     * Spaces around names are ignored and the empty string parses as the
+     * empty mask. Names of multi-bit values contribute all of their bits.
+     *
+     * @param text The names, e.g. "Read|Write".
+     * @return The OR of the named values.
+     * @throw InvalidStringValue If a name is unknown and the policy does not skip or accept it.
+     * @throw ParseError If a name is empty, e.g. in "Read||Write".
+     */
+    [[nodiscard]] constexpr E parse(std::string_view text) const {
+        uint64_t bits = 0;
+        if (trim(text).empty()) {
+            return from_bits(0);
+        }
+        while (true) {
+            std::size_t end = text.find(m_delimiter);
+            std::string_view token = trim(text.substr(0, end));
+            if (token.empty()) {
+                auto err = EnumStringException::ErrorCode::ParseError;
+                throw EnumStringException(err, "Empty flag name");
+            }
+            bits |= token_bits(token);
+            if (end == std::string_view::npos) {
+                break;
+            }
+            text.remove_prefix(end + 1);
+        }
+        return from_bits(bits);
+    }
+
+    /**
+     * @brief Parses delimited names into a mask without throwing.
+     *
+     * @return The OR of the named values, or std::nullopt where parse() would throw.
+     */
+    [[nodiscard]] std::optional<E> try_parse(std::string_view text) const {
+        try {
+            return parse(text);
+        } catch (const EnumStringException&) {
+            return std::nullopt;
+        }
+    }
+
+    /**
+     * @brief Returns the bits that have a name.
+     */
+    [[nodiscard]] constexpr E known_bits() const noexcept { return from_bits(m_known); }
+
+    /**
+     * @brief Returns the wrapped table.
+     */
+    [[nodiscard]] constexpr const EnumString<E, N, I>& table() const noexcept { return m_table; }
+
+private:
+    using Unsigned = std::make_unsigned_t<std::underlying_type_t<E>>;
+
+    EnumString<E, N, I> m_table;
+    UnknownBits m_policy;
+    char m_delimiter;
+    std::array<std::string_view, BITS> m_names{}; /**< Name of each single-bit value, by bit index. */
+    uint64_t m_known = 0;                          /**< Bits with a name. */
+    std::string_view m_zero_name;
+
+    static constexpr uint64_t to_bits(E value) noexcept {
+        return static_cast<Unsigned>(enum_to_underlying(value));
+    }
+
+    static constexpr E from_bits(uint64_t bits) noexcept {
+        return static_cast<E>(static_cast<Unsigned>(bits));
+    }
+
+    static constexpr uint64_t all_bits() noexcept {
+        return BITS == 64 ? ~uint64_t{0} : (uint64_t{1} << BITS) - 1;
+    }
+
+    /**
+     * @brief Returns the unknown bits of a mask the policy keeps, throwing if it forbids them.
+     */
+    constexpr uint64_t checked_unknown(uint64_t bits) const {
+        uint64_t unknown = bits & ~m_known;
+        if (unknown == 0 || m_policy == UnknownBits::AsHex) {
+            return unknown;
+        }
+        if (m_policy == UnknownBits::Throw) {
+            auto err = EnumStringException::ErrorCode::InvalidEnumValue;
+            throw EnumStringException(err, "Flag mask has bits without a name");
+        }
+        return 0;
+    }
+
+    static constexpr std::size_t hex_size(uint64_t bits) noexcept {
+        return 2 + (static_cast<std::size_t>(std::bit_width(bits)) + 3) / 4;
+    }
+
+    static constexpr char* write_hex(uint64_t bits, char* out) noexcept {
+        constexpr std::string_view digits = "0123456789abcdef";
+        std::size_t size = hex_size(bits);
+        out[0] = '0';
+        out[1] = 'x';
+        for (std::size_t i = size; i > 2; i--) {
+            out[i - 1] = digits[bits & 0xf];
+            bits >>= 4;
+        }
+        return out + size;
+    }
+
+    static constexpr std::string_view trim(std::string_view str) noexcept {
+        while (!str.empty() && str.front() == ' ') {
+            str.remove_prefix(1);
+        }
+        while (!str.empty() && str.back() == ' ') {
+            str.remove_suffix(1);
+        }
+        return str;
+    }
+
+    static constexpr std::optional<uint64_t> parse_hex(std::string_view token) noexcept {
+        if (token.size() < 3 || token.size() > 18 || token[0] != '0' || (token[1] != 'x' && token[1] != 'X')) {
+            return std::nullopt;
+        }
+        uint64_t bits = 0;
+        for (char c : token.substr(2)) {
+            uint64_t digit;
+            if (c >= '0' && c <= '9') {
+                digit = static_cast<uint64_t>(c - '0');
+            } else if (c >= 'a' && c <= 'f') {
+                digit = static_cast<uint64_t>(c - 'a' + 10);
+            } else if (c >= 'A' && c <= 'F') {
+                digit = static_cast<uint64_t>(c - 'A' + 10);
+            } else {
+                return std::nullopt;
+            }
+            bits = bits << 4 | digit;
+        }
+        return bits;
+    }
+
+    constexpr uint64_t token_bits(std::string_view token) const {
+        if (std::optional<E> found = m_table.try_to_enum(token)) {
+            return to_bits(*found);
+        }
+        if (m_policy == UnknownBits::Ignore) {
+            return 0;
+        }
+        if (m_policy == UnknownBits::AsHex) {
+            if (std::optional<uint64_t> bits = parse_hex(token); bits && (*bits & ~all_bits()) == 0) {
+                return *bits;
+            }
+        }
+        auto err = EnumStringException::ErrorCode::InvalidStringValue;
+        throw EnumStringException(err, "Flag name not found in the mapping");
+    }
+}; // class FlagString
+
+/**
+ * @brief Deduction guide to construct a FlagString from an EnumString.
+ */
+template<EnumType E, std::size_t N, typename I>
+FlagString(const EnumString<E, N, I>&, UnknownBits = UnknownBits::Throw, char = '|') -> FlagString<E, N, I>;
+
+}; // namespace Topname
+
+#endif // TOPNAME_FLAG_STRING_H
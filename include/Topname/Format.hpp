@@ -0,0 +1,104 @@
+#ifndef TOPNAME_FORMAT_H
+#define TOPNAME_FORMAT_H
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <optional>
+#include <ostream>
+#include <string_view>
+#include <type_traits>
+
+#include "Topname.hpp"
+
+/**
+ * @brief Binds an enum to its EnumString for operator<<.
+ *
+ * Use at namespace scope, in the namespace of the enum, after the table:
+ *
+ * @code
+ * namespace app {
+ * enum class Color { Red, Green };
+ * inline constexpr auto color_names = Topname::EnumString(Color::Red, "Red", Color::Green, "Green");
+ * TOPNAME_REGISTER_ENUM(Color, color_names)
+ * }
+ *
+ * std::cout << app::Color::Red; // "Red"
+ * @endcode
+ *
+ * Declare the table inline constexpr in headers: topname_names() is inline
+ * and returns a reference to it, and a plain constexpr variable at
+ * namespace scope would be a different object in every translation unit.
+ *
+ * It defines topname_names(Enum), found by argument-dependent lookup, which
+ * is all RegisteredEnum requires, and an operator<< next to the enum so that
+ * streaming finds it without using-declarations. Enums that can not be
+ * registered this way, e.g. those declared inside a class, can provide
+ * topname_names() as a hidden friend instead.
+ */
+#define TOPNAME_REGISTER_ENUM(Enum, table)                                  \
+    [[maybe_unused]] constexpr const auto& topname_names(Enum) noexcept {   \
+        return table;                                                       \
+    }                                                                       \
+    [[maybe_unused]] inline std::ostream& operator<<(std::ostream& os, Enum value) { \
+        return ::Topname::write_name(os, value);                            \
+    }
+
+namespace Topname {
+
+/**
+ * @brief Concept for enums bound to a table with TOPNAME_REGISTER_ENUM.
+ */
+template<typename E>
+concept RegisteredEnum = EnumType<E> && requires(E value) {
+    { topname_names(value).to_string(value) } -> std::convertible_to<std::string_view>;
+};
+
+/**
+ * @brief Returns the table an enum is registered with.
+ */
+template<RegisteredEnum E>
+constexpr const auto& registered_names() noexcept {
+    return topname_names(E{});
+}
+
+/**
+ * @brief Formats the underlying value of an enum value that has no string.
+ *
+ * @param value The enum value.
+ * @param buffer Destination for the digits.
+ * @return The digits.
+ */
+template<EnumType E>
+std::string_view underlying_digits(E value, std::array<char, 24>& buffer) noexcept {
+    auto underlying = enum_to_underlying(value);
+    auto result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), +underlying);
+    return {buffer.data(), static_cast<std::size_t>(result.ptr - buffer.data())};
+}
+
+/**
+ * @brief Writes the string of a registered enum value to a stream.
+ *
+ * Without a field width the name is written with a single unformatted
+ * write(), skipping the padding and locale handling of formatted output.
+ * Values without a string are written as their underlying value.
+ *
+ * @param os The output stream.
+ * @param value The enum value.
+ * @return The output stream.
+ */
+template<RegisteredEnum E>
+std::ostream& write_name(std::ostream& os, E value) {
+    std::array<char, 24> buffer;
+    std::optional<std::string_view> name = topname_names(value).try_to_string(value);
+    std::string_view text = name ? *name : underlying_digits(value, buffer);
+    if (os.width() == 0) {
+        return os.write(text.data(), static_cast<std::streamsize>(text.size()));
+    }
+    return os << text;
+}
+
+}; // namespace Topname
+
+#endif // TOPNAME_FORMAT_H
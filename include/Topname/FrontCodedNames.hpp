@@ -0,0 +1,363 @@
+#ifndef TOPNAME_FRONT_CODED_NAMES_H
+#define TOPNAME_FRONT_CODED_NAMES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief A compressed copy of the strings of an EnumString.
+ *
+ * Strings are sorted and stored front-coded in blocks of BLOCK_SIZE: the first
+ * string of a block is stored in full, every following one as the length of the
+ * prefix it shares with its predecessor plus the remaining suffix. Vocabularies
+ * with long common prefixes (ERROR_NETWORK_TIMEOUT_...) shrink to little more
+ * than their distinct suffixes.
+ *
+ * Enum to string decodes at most one block, so it is O(BLOCK_SIZE) = O(1);
+ * the result is written into a caller buffer by copy_to() or into a small
+ * per-thread buffer by to_string(). String to enum binary searches the block
+ * headers and then walks the block on the compressed form without decoding.
+ *
+ * @tparam E Enum type.
+ */
+template<EnumType E>
+class FrontCodedNames {
+public:
+    static constexpr std::size_t BLOCK_SIZE = 16;
+
+    /**
+     * @brief Builds the compressed store from an EnumString.
+     *
+     * @tparam N The number of mappings.
+     * @tparam I The instrumentation policy of the table.
+     * @param table The table whose strings are compressed.
+     */
+    template<std::size_t N, typename I>
+    explicit FrontCodedNames(const EnumString<E, N, I>& table) {
+        struct Entry {
+            std::string_view string_val;
+            E enum_val;
+            uint32_t order; /**< Declaration index in the table. */
+        };
+        std::vector<Entry> sorted;
+        sorted.reserve(N);
+        table.for_each_pair([&sorted](E enum_val, std::string_view str_val) {
+            sorted.push_back({str_val, enum_val, static_cast<uint32_t>(sorted.size())});
+        });
+        // Stable, so that duplicate strings resolve to the first declared value like to_enum().
+        std::stable_sort(sorted.begin(), sorted.end(), [](const Entry& a, const Entry& b) {
+            return a.string_val < b.string_val;
+        });
+
+        m_rank_enum.reserve(sorted.size());
+        std::vector<uint32_t> rank_order;
+        rank_order.reserve(sorted.size());
+        std::string_view previous;
+        for (std::size_t rank = 0; rank < sorted.size(); rank++) {
+            std::string_view str = sorted[rank].string_val;
+            m_rank_enum.push_back(sorted[rank].enum_val);
+            rank_order.push_back(sorted[rank].order);
+            m_max_length = std::max(m_max_length, str.size());
+            if (rank % BLOCK_SIZE == 0) {
+                m_block_offsets.push_back(static_cast<uint32_t>(m_blob.size()));
+                put_varint(str.size());
+                m_blob.insert(m_blob.end(), str.begin(), str.end());
+            } else {
+                std::size_t shared = common_prefix(previous, str);
+                put_varint(shared);
+                put_varint(str.size() - shared);
+                m_blob.insert(m_blob.end(), str.begin() + shared, str.end());
+            }
+            previous = str;
+        }
+        m_blob.shrink_to_fit();
+        build_enum_index(rank_order);
+    }
+
+    /**
+     * @brief Writes the string of an enum value into a caller buffer.
+     *
+     * @param value The enum value to convert.
+     * @param out Destination with room for at least max_string_length() characters.
+     * @return The number of characters written; no terminator is appended.
+     * @throw InvalidEnumValue If the enum value does not match any string.
+     */
+    std::size_t copy_to(E value, char* out) const {
+        std::size_t rank = rank_of(value);
+        const unsigned char* p = m_blob.data() + m_block_offsets[rank / BLOCK_SIZE];
+        std::size_t length = get_varint(p);
+        std::memcpy(out, p, length);
+        p += length;
+        for (std::size_t i = rank % BLOCK_SIZE; i > 0; i--) {
+            std::size_t shared = get_varint(p);
+            std::size_t suffix = get_varint(p);
+            std::memcpy(out + shared, p, suffix);
+            p += suffix;
+            length = shared + suffix;
+        }
+        return length;
+    }
+
+    /**
+     * @brief Converts an enum value to its string using a per-thread decode buffer.
+     *
+     * @param value The enum value to convert.
+     * @return The string, valid until the next to_string() call on the same thread.
+     * @throw InvalidEnumValue If the enum value does not match any string.
+     */
+    [[nodiscard]] std::string_view to_string(E value) const {
+        thread_local std::string buffer;
+        if (buffer.size() < m_max_length) {
+            buffer.resize(m_max_length);
+        }
+        return {buffer.data(), copy_to(value, buffer.data())};
+    }
+
+    /**
+     * @brief Converts a string to its corresponding enum value.
+     *
+     * Time complexity: O(log(N / BLOCK_SIZE) + BLOCK_SIZE), without decoding.
+     *
+     * @param value The string to convert.
+     * @return The corresponding enum value.
+     * @throw InvalidStringValue If the string does not match any enum value.
+     */
+    [[nodiscard]] E to_enum(std::string_view value) const {
+        std::size_t rank = find_rank(value);
+        if (rank == NOT_FOUND) {
+            auto err = EnumStringException::ErrorCode::InvalidStringValue;
+            throw EnumStringException(err, "String value not found in the mapping");
+        }
+        return m_rank_enum[rank];
+    }
+
+    /**
+     * @brief Checks if a given string value exists in the store.
+     */
+    [[nodiscard]] bool contains(std::string_view target) const {
+        return find_rank(target) != NOT_FOUND;
+    }
+
+    /**
+     * @brief Checks if a given enum value exists in the store.
+     */
+    [[nodiscard]] bool contains(E target) const {
+        return lookup_rank(target) != NOT_FOUND;
+    }
+
+    /**
+     * @brief Returns the number of strings.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return m_rank_enum.size(); }
+
+    /**
+     * @brief Returns the length of the longest string, the buffer size required by copy_to().
+     */
+    [[nodiscard]] std::size_t max_string_length() const noexcept { return m_max_length; }
+
+    /**
+     * @brief Returns the number of bytes held by the store.
+     */
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        return sizeof(*this)
+             + m_blob.capacity()
+             + m_block_offsets.capacity() * sizeof(uint32_t)
+             + m_rank_enum.capacity() * sizeof(E)
+             + m_dense_rank.capacity() * sizeof(uint32_t)
+             + m_sorted_enums.capacity() * sizeof(std::pair<E, uint32_t>);
+    }
+
+private:
+    static constexpr std::size_t NOT_FOUND = static_cast<std::size_t>(-1);
+
+    std::vector<unsigned char> m_blob;
+    std::vector<uint32_t> m_block_offsets;
+    std::vector<E> m_rank_enum; /**< Enum value of each string, in sorted string order. */
+    std::size_t m_max_length = 0;
+
+    // Enum to rank: a direct table for (nearly) dense enums, otherwise a sorted list.
+    std::underlying_type_t<E> m_enum_min{};
+    std::vector<uint32_t> m_dense_rank;
+    std::vector<std::pair<E, uint32_t>> m_sorted_enums;
+
+    static std::size_t common_prefix(std::string_view a, std::string_view b) noexcept {
+        auto [ia, ib] = std::mismatch(a.begin(), a.end(), b.begin(), b.end());
+        return static_cast<std::size_t>(ia - a.begin());
+    }
+
+    void put_varint(std::size_t value) {
+        while (value >= 0x80) {
+            m_blob.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        m_blob.push_back(static_cast<unsigned char>(value));
+    }
+
+    static std::size_t get_varint(const unsigned char*& p) noexcept {
+        std::size_t value = 0;
+        for (unsigned shift = 0;; shift += 7) {
+            unsigned char byte = *p++;
+            value |= static_cast<std::size_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+    }
+
+    /**
+     * @brief Indexes the ranks by enum value.
+     *
+     * A value with several strings maps to the rank of the first declared
+     * one, so that to_string() agrees with EnumString::to_string().
+     *
+     * @param rank_order The declaration index of the string at each rank.
+     */
+    void build_enum_index(const std::vector<uint32_t>& rank_order) {
+        if (m_rank_enum.empty()) {
+            return;
+        }
+        auto [lo, hi] = std::minmax_element(m_rank_enum.begin(), m_rank_enum.end(),
+            [](E a, E b) { return enum_to_underlying(a) < enum_to_underlying(b); });
+        m_enum_min = enum_to_underlying(*lo);
+        uint64_t span = enum_offset(*hi, m_enum_min);
+
+        if (span < 2 * m_rank_enum.size() + 64) {
+            m_dense_rank.assign(span + 1, static_cast<uint32_t>(NOT_FOUND));
+            for (std::size_t rank = 0; rank < m_rank_enum.size(); rank++) {
+                uint32_t& slot = m_dense_rank[enum_offset(m_rank_enum[rank], m_enum_min)];
+                if (slot == static_cast<uint32_t>(NOT_FOUND) || rank_order[rank] < rank_order[slot]) {
+                    slot = static_cast<uint32_t>(rank);
+                }
+            }
+            return;
+        }
+
+        for (std::size_t rank = 0; rank < m_rank_enum.size(); rank++) {
+            m_sorted_enums.emplace_back(m_rank_enum[rank], static_cast<uint32_t>(rank));
+        }
+        std::sort(m_sorted_enums.begin(), m_sorted_enums.end(), [&rank_order](const auto& a, const auto& b) {
+            if (a.first != b.first) {
+                return enum_to_underlying(a.first) < enum_to_underlying(b.first);
+            }
+            return rank_order[a.second] < rank_order[b.second];
+        });
+    }
+
+    std::size_t lookup_rank(E value) const noexcept {
+        auto underlying = enum_to_underlying(value);
+        if (!m_dense_rank.empty()) {
+            if (underlying < m_enum_min) {
+                return NOT_FOUND;
+            }
+            uint64_t offset = enum_offset(value, m_enum_min);
+            if (offset >= m_dense_rank.size() || m_dense_rank[offset] == static_cast<uint32_t>(NOT_FOUND)) {
+                return NOT_FOUND;
+            }
+            return m_dense_rank[offset];
+        }
+        auto it = std::lower_bound(m_sorted_enums.begin(), m_sorted_enums.end(), underlying,
+            [](const auto& pair, auto key) { return enum_to_underlying(pair.first) < key; });
+        if (it == m_sorted_enums.end() || it->first != value) {
+            return NOT_FOUND;
+        }
+        return it->second;
+    }
+
+    std::size_t rank_of(E value) const {
+        std::size_t rank = lookup_rank(value);
+        if (rank == NOT_FOUND) {
+            auto err = EnumStringException::ErrorCode::InvalidEnumValue;
+            throw EnumStringException(err, "Enum value not found in the mapping");
+        }
+        return rank;
+    }
+
+    std::string_view block_header(std::size_t block) const noexcept {
+        const unsigned char* p = m_blob.data() + m_block_offsets[block];
+        std::size_t length = get_varint(p);
+        return {reinterpret_cast<const char*>(p), length};
+    }
+
+    std::size_t find_rank(std::string_view key) const noexcept {
+        // First block whose first string is >= key.
+        std::size_t lo = 0, hi = m_block_offsets.size();
+        while (lo < hi) {
+            std::size_t mid = lo + (hi - lo) / 2;
+            if (block_header(mid) < key) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        // Copies of a string are adjacent, first declared first, and may start at the end of the
+        // previous block even when the key heads this one.
+        if (lo > 0) {
+            std::size_t rank = find_in_block(lo - 1, key);
+            if (rank != NOT_FOUND) {
+                return rank;
+            }
+        }
+        if (lo < m_block_offsets.size() && block_header(lo) == key) {
+            return lo * BLOCK_SIZE;
+        }
+        return NOT_FOUND;
+    }
+
+    /**
+     * @brief Returns the first rank of a key in a block whose first string is < key, or NOT_FOUND.
+     */
+    std::size_t find_in_block(std::size_t block, std::string_view key) const noexcept {
+        const unsigned char* p = m_blob.data() + m_block_offsets[block];
+        std::size_t length = get_varint(p);
+        std::string_view header(reinterpret_cast<const char*>(p), length);
+        p += length;
+
+        // matched is the common prefix of key and the current string, which is < key.
+        std::size_t matched = common_prefix(header, key);
+        std::size_t end = std::min(m_rank_enum.size(), (block + 1) * BLOCK_SIZE);
+        for (std::size_t rank = block * BLOCK_SIZE + 1; rank < end; rank++) {
+            std::size_t shared = get_varint(p);
+            std::size_t suffix_length = get_varint(p);
+            std::string_view suffix(reinterpret_cast<const char*>(p), suffix_length);
+            p += suffix_length;
+
+            if (shared > matched) {
+                continue; // Agrees with the previous string past the point where it was below key.
+            }
+            if (shared < matched) {
+                return NOT_FOUND; // Diverges upwards at a position where key still matched.
+            }
+            std::size_t more = common_prefix(suffix, key.substr(matched));
+            matched += more;
+            if (more == suffix_length && matched == key.size()) {
+                return rank;
+            }
+            if (more == suffix_length || (matched < key.size() &&
+                static_cast<unsigned char>(suffix[more]) < static_cast<unsigned char>(key[matched]))) {
+                continue; // Still below key.
+            }
+            return NOT_FOUND;
+        }
+        return NOT_FOUND;
+    }
+}; // class FrontCodedNames
+
+/**
+ * @brief Deduction guide to construct a FrontCodedNames from an EnumString.
+ */
+template<EnumType E, std::size_t N, typename I>
+FrontCodedNames(const EnumString<E, N, I>&) -> FrontCodedNames<E>;
+
+}; // namespace Topname
+
+#endif // TOPNAME_FRONT_CODED_NAMES_H
@@ -0,0 +1,566 @@
+#ifndef TOPNAME_INSTRUMENTATION_H
+#define TOPNAME_INSTRUMENTATION_H
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional> // std::invoke
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief A log-linear latency histogram in the style of HdrHistogram.
+ *
+ * Values below 2^SUB_BUCKET_BITS nanoseconds get a bucket each; above that,
+ * every power of two is split into 2^SUB_BUCKET_BITS linear buckets, which
+ * bounds the relative error to 1/8. Values are clamped to 2^MAX_EXPONENT ns.
+ */
+struct LatencyHistogram {
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;
+    static constexpr unsigned MAX_EXPONENT = 40; /**< About 18 minutes. */
+    static constexpr std::size_t BUCKETS = (MAX_EXPONENT - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    /**
+     * @brief Returns the bucket recording a value.
+     */
+    static constexpr std::size_t bucket_of(uint64_t ns) noexcept {
+        ns = std::min<uint64_t>(ns, (uint64_t{1} << MAX_EXPONENT) - 1);
+        if (ns < SUB_BUCKETS) {
+            return static_cast<std::size_t>(ns);
+        }
+        unsigned exponent = static_cast<unsigned>(std::bit_width(ns)) - 1;
+        uint64_t sub = (ns >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+        return (exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + static_cast<std::size_t>(sub);
+    }
+
+    /**
+     * @brief Returns the largest value recorded by a bucket.
+     */
+    static constexpr uint64_t upper_bound(std::size_t bucket) noexcept {
+        if (bucket < SUB_BUCKETS) {
+            return bucket;
+        }
+        unsigned exponent = static_cast<unsigned>(bucket / SUB_BUCKETS) + SUB_BUCKET_BITS - 1;
+        uint64_t sub = bucket % SUB_BUCKETS;
+        uint64_t width = uint64_t{1} << (exponent - SUB_BUCKET_BITS);
+        return (uint64_t{1} << exponent) + (sub + 1) * width - 1;
+    }
+};
+
+/**
+ * @brief Aggregated counters of one instrumented table.
+ */
+struct InstrumentationSnapshot {
+    static constexpr std::size_t OPS = 5;
+
+    std::array<uint64_t, OPS> lookups{};
+    std::array<uint64_t, OPS> hits{};
+    std::array<uint64_t, LatencyHistogram::BUCKETS> latency{};
+    uint64_t latency_sum_ns = 0;
+};
+
+/**
+ * @brief Returns the exported name of a lookup operation.
+ */
+constexpr std::string_view lookup_op_name(LookupOp op) {
+    switch (op) {
+        case LookupOp::ToEnum: return "to_enum";
+        case LookupOp::ToEnumInsensitive: return "to_enum_insensitive";
+        case LookupOp::ToString: return "to_string";
+        case LookupOp::ContainsEnum: return "contains_enum";
+        case LookupOp::ContainsString: return "contains_string";
+    }
+    return "unknown";
+}
+
+/**
+ * @brief Writes an InstrumentationSnapshot in the Prometheus text exposition format.
+ *
+ * The histogram always has one bucket per LatencyHistogram bucket up to
+ * "+Inf", and every operation has its hit and miss counters, so consecutive
+ * scrapes see the same series.
+ *
+ * @param os The output stream.
+ * @param table The table label.
+ * @param snap The counters to write.
+ */
+inline void write_instrumentation(std::ostream& os, std::string_view table, const InstrumentationSnapshot& snap) {
+    // Every series is written on every scrape, zero or not, so that the set of series never changes.
+    for (std::size_t op = 0; op < InstrumentationSnapshot::OPS; op++) {
+        std::string_view name = lookup_op_name(static_cast<LookupOp>(op));
+        os << "topname_lookups_total{table=\"" << table << "\",op=\"" << name << "\",result=\"hit\"} "
+           << snap.hits[op] << '\n';
+        os << "topname_lookups_total{table=\"" << table << "\",op=\"" << name << "\",result=\"miss\"} "
+           << snap.lookups[op] - snap.hits[op] << '\n';
+    }
+
+    uint64_t cumulative = 0;
+    for (std::size_t b = 0; b < LatencyHistogram::BUCKETS; b++) {
+        cumulative += snap.latency[b];
+        os << "topname_lookup_latency_ns_bucket{table=\"" << table << "\",le=\""
+           << LatencyHistogram::upper_bound(b) << "\"} " << cumulative << '\n';
+    }
+    os << "topname_lookup_latency_ns_bucket{table=\"" << table << "\",le=\"+Inf\"} " << cumulative << '\n';
+    os << "topname_lookup_latency_ns_sum{table=\"" << table << "\"} " << snap.latency_sum_ns << '\n';
+    os << "topname_lookup_latency_ns_count{table=\"" << table << "\"} " << cumulative << '\n';
+}
+
+/**
+ * @brief Process-wide list of instrumented tables, used by export_instrumentation().
+ */
+class InstrumentationRegistry {
+public:
+    using ExportFn = void (*)(std::ostream&);
+
+    static InstrumentationRegistry& instance() {
+        static InstrumentationRegistry registry;
+        return registry;
+    }
+
+    void add(ExportFn fn) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exporters.push_back(fn);
+    }
+
+    void export_all(std::ostream& os) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        for (ExportFn fn : m_exporters) {
+            fn(os);
+        }
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::vector<ExportFn> m_exporters;
+};
+
+/**
+ * @brief Writes the counters of every instrumented table that has been used so far.
+ *
+ * @param os The output stream.
+ */
+inline void export_instrumentation(std::ostream& os) {
+    InstrumentationRegistry::instance().export_all(os);
+}
+
+/**
+ * @brief An EnumString instrumentation policy counting hits, misses and latency.
+ *
+ * Each thread records into its own cache-line-aligned block, taken on the
+ * thread's first lookup, so lookups never contend; the counters are relaxed
+ * atomics written only by their owner. When the thread exits, its block goes
+ * to a free list and the next new thread continues counting in it, so the
+ * number of blocks follows the peak number of threads rather than every
+ * thread ever started. If no block can be allocated, the thread
+ * records into a block shared by all such threads instead, with atomic
+ * increments, so recording never throws. snapshot() sums the blocks of all
+ * threads, including threads that have exited. Lookups evaluated at compile
+ * time are not recorded.
+ *
+ * @code
+ * struct PlanetsTag { static constexpr std::string_view name = "planets"; };
+ * constexpr auto planets = EnumString(...).with_instrumentation<LookupInstrumentation<PlanetsTag>>();
+ * @endcode
+ *
+ * @tparam Tag A type with a static `name` used as the table label; one set of counters per Tag.
+ */
+template<typename Tag>
+class LookupInstrumentation {
+private:
+    struct alignas(64) ThreadBlock {
+        std::array<std::atomic<uint64_t>, InstrumentationSnapshot::OPS> lookups{};
+        std::array<std::atomic<uint64_t>, InstrumentationSnapshot::OPS> hits{};
+        std::array<std::atomic<uint64_t>, LatencyHistogram::BUCKETS> latency{};
+        std::atomic<uint64_t> latency_sum_ns{0};
+    };
+
+    struct State {
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadBlock>> blocks;
+        std::vector<ThreadBlock*> free_blocks; /**< Blocks of exited threads; capacity for all blocks. */
+        ThreadBlock shared;      /**< Written by threads whose own block could not be allocated. */
+        bool registered = false; /**< Whether export_text() is in the InstrumentationRegistry. */
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    /**
+     * @brief Holds the block of one thread and returns it to the free list when the thread exits.
+     */
+    class ThreadLease {
+    public:
+        ThreadLease() noexcept : m_block(acquire()) {}
+
+        ~ThreadLease() {
+            if (m_block == nullptr) {
+                return;
+            }
+            State& s = state();
+            try {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                s.free_blocks.push_back(m_block); // Never reallocates, see acquire().
+            } catch (...) {
+                // The block stays counted in snapshot(), it is only not reused.
+            }
+        }
+
+        ThreadLease(const ThreadLease&) = delete;
+        ThreadLease& operator=(const ThreadLease&) = delete;
+
+        ThreadBlock* block() const noexcept { return m_block; }
+
+    private:
+        ThreadBlock* m_block;
+
+        static ThreadBlock* acquire() noexcept {
+            State& s = state();
+            try {
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (!s.registered) {
+                    InstrumentationRegistry::instance().add(&export_text);
+                    s.registered = true;
+                }
+                if (!s.free_blocks.empty()) {
+                    ThreadBlock* block = s.free_blocks.back();
+                    s.free_blocks.pop_back();
+                    return block;
+                }
+                // Room for every block in the free list, so that releasing one can not fail to allocate.
+                s.free_blocks.reserve(s.blocks.size() + 1);
+                s.blocks.push_back(std::make_unique<ThreadBlock>());
+                return s.blocks.back().get();
+            } catch (...) {
+                return nullptr;
+            }
+        }
+    };
+
+    /**
+     * @brief Returns the block of the calling thread, or nullptr if it could not be allocated.
+     */
+    static ThreadBlock* thread_block() noexcept {
+        thread_local ThreadLease lease;
+        return lease.block();
+    }
+
+    static void bump(std::atomic<uint64_t>& counter, bool shared, uint64_t amount = 1) noexcept {
+        if (shared) {
+            counter.fetch_add(amount, std::memory_order_relaxed);
+            return;
+        }
+        // Single writer per block, so a load and a store suffice.
+        counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+    }
+
+    static uint64_t now_ns() noexcept {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+public:
+    /**
+     * @brief Times one lookup and records it when it ends.
+     */
+    class Scope {
+    public:
+        constexpr explicit Scope(LookupOp op) noexcept : m_op(op) {
+            if (!std::is_constant_evaluated()) {
+                m_start = now_ns();
+            }
+        }
+
+        constexpr void hit() noexcept { m_hit = true; }
+        constexpr void miss(std::string_view) noexcept {}
+
+        constexpr ~Scope() {
+            if (!std::is_constant_evaluated()) {
+                record(m_op, m_hit, now_ns() - m_start);
+            }
+        }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        LookupOp m_op;
+        bool m_hit = false;
+        uint64_t m_start = 0;
+    };
+
+    /**
+     * @brief Records a finished lookup for the calling thread.
+     *
+     * The first call on a thread takes a free block or allocates one; if
+     * that fails, the lookup goes to the shared block.
+     */
+    static void record(LookupOp op, bool hit, uint64_t latency_ns) noexcept {
+        ThreadBlock* own = thread_block();
+        bool shared = own == nullptr;
+        ThreadBlock& block = shared ? state().shared : *own;
+        auto index = static_cast<std::size_t>(op);
+        bump(block.lookups[index], shared);
+        if (hit) {
+            bump(block.hits[index], shared);
+        }
+        bump(block.latency[LatencyHistogram::bucket_of(latency_ns)], shared);
+        bump(block.latency_sum_ns, shared, latency_ns);
+    }
+
+    /**
+     * @brief Sums the counters of all threads.
+     */
+    static InstrumentationSnapshot snapshot() {
+        InstrumentationSnapshot snap;
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        auto add = [&snap](const ThreadBlock& block) {
+            for (std::size_t op = 0; op < InstrumentationSnapshot::OPS; op++) {
+                snap.lookups[op] += block.lookups[op].load(std::memory_order_relaxed);
+                snap.hits[op] += block.hits[op].load(std::memory_order_relaxed);
+            }
+            for (std::size_t b = 0; b < LatencyHistogram::BUCKETS; b++) {
+                snap.latency[b] += block.latency[b].load(std::memory_order_relaxed);
+            }
+            snap.latency_sum_ns += block.latency_sum_ns.load(std::memory_order_relaxed);
+        };
+        for (const auto& block : s.blocks) {
+            add(*block);
+        }
+        add(s.shared);
+        return snap;
+    }
+
+    /**
+     * @brief Returns the number of per-thread blocks allocated so far, in use or free.
+     */
+    static std::size_t thread_blocks() {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        return s.blocks.size();
+    }
+
+    /**
+     * @brief Writes this table's counters in the Prometheus text exposition format.
+     */
+    static void export_text(std::ostream& os) {
+        write_instrumentation(os, Tag::name, snapshot());
+    }
+};
+
+/**
+ * @brief A string that missed a lookup, as returned by UnknownValueCapture::drain().
+ */
+struct CapturedMiss {
+    LookupOp op;
+    std::string_view value;      /**< The first bytes of the input, valid during the callback. */
+    std::size_t original_length; /**< The length of the input before truncation. */
+
+    [[nodiscard]] bool truncated() const noexcept { return value.size() < original_length; }
+};
+
+/**
+ * @brief An EnumString instrumentation policy sampling the strings that failed to resolve.
+ *
+ * Missed inputs (to_enum, to_enum_insensitive, contains) are copied, truncated
+ * to MaxBytes, into a bounded lock-free ring of Slots entries. Every engine
+ * compares strings, so an unknown input is a miss even if it shares a hash
+ * with a mapped string. to_enum_from_quoted() reports the unescaped token
+ * without its quotes; escaped tokens are cut to their first 64 unescaped
+ * bytes, so original_length is at most 64 for them. The miss path
+ * never allocates or blocks: at most MaxPerSecond inputs are captured per
+ * second, and a miss that finds the ring full is dropped and counted. A
+ * diagnostics thread empties the ring with drain().
+ *
+ * The ring is the bounded MPMC queue by Dmitry Vyukov: each slot carries a
+ * sequence number telling writers whether it is free for the current lap and
+ * the reader whether it has been published.
+ *
+ * @tparam Tag Any type; one ring per Tag.
+ * @tparam Slots Ring capacity, a power of two.
+ * @tparam MaxBytes Bytes copied per input.
+ * @tparam MaxPerSecond Captures allowed per second.
+ */
+template<typename Tag, std::size_t Slots = 64, std::size_t MaxBytes = 64, uint32_t MaxPerSecond = 100>
+class UnknownValueCapture {
+    static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;
+        uint32_t length;
+        LookupOp op;
+        char data[MaxBytes];
+    };
+
+    struct State {
+        std::array<Slot, Slots> ring;
+        std::atomic<uint64_t> enqueue_pos{0};
+        uint64_t dequeue_pos = 0;            /**< Guarded by reader_mutex. */
+        std::atomic<int64_t> window{-1};     /**< Current rate-limit second. */
+        std::atomic<uint32_t> window_count{0};
+        std::atomic<uint64_t> dropped{0};
+        std::atomic<uint64_t> rate_limited{0};
+        std::mutex reader_mutex;
+
+        State() {
+            for (std::size_t i = 0; i < Slots; i++) {
+                ring[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    static State& state() {
+        static State s;
+        return s;
+    }
+
+    static bool admit(State& s) noexcept {
+        auto now = std::chrono::duration_cast<std::chrono::seconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t window = s.window.load(std::memory_order_relaxed);
+        if (window != now && s.window.compare_exchange_strong(window, now, std::memory_order_relaxed)) {
+            s.window_count.store(0, std::memory_order_relaxed);
+        }
+        if (s.window_count.fetch_add(1, std::memory_order_relaxed) >= MaxPerSecond) {
+            s.rate_limited.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+public:
+    /**
+     * @brief Captures the input of a failed string lookup.
+     */
+    class Scope {
+    public:
+        constexpr explicit Scope(LookupOp op) noexcept : m_op(op) {}
+        constexpr void hit() noexcept {}
+        constexpr void miss(std::string_view value) noexcept {
+            if (!std::is_constant_evaluated()) {
+                capture(m_op, value);
+            }
+        }
+
+    private:
+        LookupOp m_op;
+    };
+
+    /**
+     * @brief Copies a missed input into the ring, unless rate-limited or full.
+     *
+     * @return True if the input was captured.
+     */
+    static bool capture(LookupOp op, std::string_view value) noexcept {
+        State& s = state();
+        if (!admit(s)) {
+            return false;
+        }
+        uint64_t pos = s.enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Slot& slot = s.ring[pos & (Slots - 1)];
+            uint64_t seq = slot.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<int64_t>(seq - pos);
+            if (diff == 0) {
+                if (s.enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    std::size_t bytes = std::min(value.size(), MaxBytes);
+                    std::memcpy(slot.data, value.data(), bytes);
+                    slot.length = static_cast<uint32_t>(std::min<std::size_t>(value.size(), UINT32_MAX));
+                    slot.op = op;
+                    slot.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                s.dropped.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                pos = s.enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief Removes every published capture from the ring, oldest first.
+     *
+     * @tparam Func Callable taking a const CapturedMiss&.
+     * @param func Called once per capture.
+     * @return The number of captures delivered.
+     */
+    template<typename Func>
+    static std::size_t drain(Func&& func) {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.reader_mutex);
+        std::size_t count = 0;
+        while (true) {
+            Slot& slot = s.ring[s.dequeue_pos & (Slots - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != s.dequeue_pos + 1) {
+                return count;
+            }
+            std::size_t bytes = std::min<std::size_t>(slot.length, MaxBytes);
+            const CapturedMiss miss{slot.op, std::string_view(slot.data, bytes), slot.length};
+            std::invoke(func, miss);
+            slot.sequence.store(s.dequeue_pos + Slots, std::memory_order_release);
+            s.dequeue_pos++;
+            count++;
+        }
+    }
+
+    /**
+     * @brief Returns the number of misses dropped because the ring was full.
+     */
+    static uint64_t dropped() noexcept { return state().dropped.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Returns the number of misses skipped by the rate limiter.
+     */
+    static uint64_t rate_limited() noexcept { return state().rate_limited.load(std::memory_order_relaxed); }
+};
+
+/**
+ * @brief An instrumentation policy forwarding every event to several policies.
+ *
+ * @code
+ * using Policy = CombinedInstrumentation<LookupInstrumentation<Tag>, UnknownValueCapture<Tag>>;
+ * @endcode
+ *
+ * @tparam Policies The policies to notify, in order.
+ */
+template<typename... Policies>
+struct CombinedInstrumentation {
+    class Scope {
+    public:
+        constexpr explicit Scope(LookupOp op) noexcept : m_scopes((static_cast<void>(sizeof(Policies)), op)...) {}
+
+        constexpr void hit() noexcept {
+            std::apply([](auto&... scope) { (scope.hit(), ...); }, m_scopes);
+        }
+
+        constexpr void miss(std::string_view value) noexcept {
+            std::apply([value](auto&... scope) { (scope.miss(value), ...); }, m_scopes);
+        }
+
+    private:
+        std::tuple<typename Policies::Scope...> m_scopes;
+    };
+};
+
+}; // namespace Topname
+
+#endif // TOPNAME_INSTRUMENTATION_H
@@ -0,0 +1,390 @@
+#ifndef TOPNAME_INTERNER_H
+#define TOPNAME_INTERNER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional> // std::invoke
+#include <limits>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "Topname.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define TOPNAME_PREFETCH(addr) __builtin_prefetch(addr)
+#else
+#define TOPNAME_PREFETCH(addr) ((void)(addr))
+#endif
+
+namespace Topname {
+
+/**
+ * @brief Maps strings to dense uint32_t ids for runtime vocabularies of any size.
+ *
+ * Offers the to_enum/to_string interface of EnumString, with ids assigned in
+ * insertion order starting at 0. Strings are copied into an arena of large
+ * chunks and never move, so views returned by to_string() stay valid for the
+ * lifetime of the interner.
+ *
+ * The index is an open-addressing table of 8-byte slots (hash, id) with linear
+ * probing. Growing does not rehash everything at once: the previous table is
+ * kept and migrated a few slots per insertion, lookups consult both tables
+ * until the migration completes.
+ *
+ * Approximate memory per entry: the string bytes, a 4-byte length prefix, an
+ * 8-byte pointer and 8-byte slots at a load factor of at most 3/4.
+ */
+class StringInterner {
+public:
+    /** @brief Returned by find() when the string is not interned. */
+    static constexpr uint32_t npos = std::numeric_limits<uint32_t>::max();
+
+    StringInterner() = default;
+    StringInterner(const StringInterner&) = delete;
+    StringInterner& operator=(const StringInterner&) = delete;
+    StringInterner(StringInterner&&) noexcept = default;
+    StringInterner& operator=(StringInterner&&) noexcept = default;
+
+    /**
+     * @brief Returns the id of a string, interning it first if needed.
+     *
+     * Amortized time complexity: O(1), without rehash pauses.
+     *
+     * @param value The string to intern.
+     * @return The dense id of the string.
+     * @throw OutOfRange If the string or the number of ids exceeds 32 bits.
+     */
+    uint32_t intern(std::string_view value) {
+        uint32_t h = mix_hash(hash(value));
+        uint32_t id = find_hashed(value, h);
+        if (id != npos) {
+            return id;
+        }
+
+        if (m_strings.size() >= npos - 1 || value.size() > std::numeric_limits<uint32_t>::max()) {
+            auto err = EnumStringException::ErrorCode::OutOfRange;
+            throw EnumStringException(err, "String interner capacity exceeded");
+        }
+
+        migrate_step();
+        if ((m_strings.size() + 1) * 4 > m_table.size() * 3) {
+            grow();
+        }
+
+        id = static_cast<uint32_t>(m_strings.size());
+        m_strings.push_back(store(value));
+        insert_slot(m_table, {h, id + 1});
+        return id;
+    }
+
+    /**
+     * @brief Looks up the id of a string without interning it.
+     *
+     * @param value The string to look up.
+     * @return The id, or npos if the string was never interned.
+     */
+    [[nodiscard]] uint32_t find(std::string_view value) const {
+        return find_hashed(value, mix_hash(hash(value)));
+    }
+
+    /**
+     * @brief Looks up many strings at once, overlapping their cache misses.
+     *
+     * Keys are processed in groups of BATCH_GROUP_SIZE. Each stage runs over the
+     * whole group before the next one starts: hash and prefetch the home slot,
+     * probe for a matching hash and prefetch the id entry, prefetch the arena
+     * string, then compare. The misses of one stage are therefore in flight
+     * together instead of being serialized key by key. Keys needing a second
+     * probe or the table being migrated fall back to find().
+     *
+     * @param keys The strings to look up.
+     * @param out Receives the id of each key, or npos; must be at least as long as keys.
+     * @throw OutOfRange If out is shorter than keys.
+     */
+    void find_batch(std::span<const std::string_view> keys, std::span<uint32_t> out) const {
+        if (out.size() < keys.size()) {
+            auto err = EnumStringException::ErrorCode::OutOfRange;
+            throw EnumStringException(err, "Output span is shorter than the key span");
+        }
+        if (m_table.empty()) {
+            std::fill_n(out.begin(), keys.size(), npos);
+            return;
+        }
+
+        const std::size_t mask = m_table.size() - 1;
+        uint32_t hashes[BATCH_GROUP_SIZE];
+        std::size_t slots[BATCH_GROUP_SIZE];
+
+        for (std::size_t base = 0; base < keys.size(); base += BATCH_GROUP_SIZE) {
+            const std::size_t count = std::min(BATCH_GROUP_SIZE, keys.size() - base);
+
+            for (std::size_t i = 0; i < count; i++) {
+                hashes[i] = mix_hash(hash(keys[base + i]));
+                slots[i] = hashes[i] & mask;
+                TOPNAME_PREFETCH(&m_table[slots[i]]);
+            }
+
+            for (std::size_t i = 0; i < count; i++) {
+                std::size_t slot = slots[i];
+                while (m_table[slot].id_plus_one != 0 && m_table[slot].hash != hashes[i]) {
+                    slot = (slot + 1) & mask;
+                }
+                slots[i] = slot;
+                if (m_table[slot].id_plus_one != 0) {
+                    TOPNAME_PREFETCH(&m_strings[m_table[slot].id_plus_one - 1]);
+                }
+            }
+
+            for (std::size_t i = 0; i < count; i++) {
+                if (m_table[slots[i]].id_plus_one != 0) {
+                    TOPNAME_PREFETCH(m_strings[m_table[slots[i]].id_plus_one - 1]);
+                }
+            }
+
+            for (std::size_t i = 0; i < count; i++) {
+                const Slot& slot = m_table[slots[i]];
+                std::string_view key = keys[base + i];
+                if (slot.id_plus_one != 0 && view(m_strings[slot.id_plus_one - 1]) == key) {
+                    out[base + i] = slot.id_plus_one - 1;
+                } else if (slot.id_plus_one != 0 || !m_old.empty()) {
+                    out[base + i] = find_hashed(key, hashes[i]);
+                } else {
+                    out[base + i] = npos;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Converts a string to its id.
+     *
+     * Average time complexity: O(1).
+     *
+     * @param value The string to convert.
+     * @return The corresponding id.
+     * @throw InvalidStringValue If the string was never interned.
+     */
+    [[nodiscard]] uint32_t to_enum(std::string_view value) const {
+        uint32_t id = find(value);
+        if (id == npos) {
+            auto err = EnumStringException::ErrorCode::InvalidStringValue;
+            throw EnumStringException(err, "String value not found in the mapping");
+        }
+        return id;
+    }
+
+    /**
+     * @brief Converts an id to its string.
+     *
+     * @param id The id to convert.
+     * @return The interned string, valid for the lifetime of the interner.
+     * @throw InvalidEnumValue If no string has this id.
+     */
+    [[nodiscard]] std::string_view to_string(uint32_t id) const {
+        if (id >= m_strings.size()) {
+            auto err = EnumStringException::ErrorCode::InvalidEnumValue;
+            throw EnumStringException(err, "Enum value not found in the mapping");
+        }
+        return view(m_strings[id]);
+    }
+
+    /**
+     * @brief Checks if a given id has been assigned.
+     */
+    [[nodiscard]] bool contains(uint32_t id) const noexcept { return id < m_strings.size(); }
+
+    /**
+     * @brief Checks if a given string has been interned.
+     */
+    [[nodiscard]] bool contains(std::string_view target) const { return find(target) != npos; }
+
+    /**
+     * @brief Returns the number of interned strings.
+     */
+    [[nodiscard]] std::size_t size() const noexcept { return m_strings.size(); }
+
+    /**
+     * @brief Returns the number of bytes currently allocated by the interner.
+     */
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        return m_chunk_bytes
+             + m_strings.capacity() * sizeof(const char*)
+             + (m_table.capacity() + m_old.capacity()) * sizeof(Slot)
+             + m_chunks.capacity() * sizeof(std::unique_ptr<char[]>);
+    }
+
+    /**
+     * @brief Pre-sizes the index and id storage for a number of strings.
+     *
+     * @param count The expected number of strings.
+     */
+    void reserve(std::size_t count) {
+        m_strings.reserve(count);
+        if (count * 4 > m_table.size() * 3) {
+            finish_migration();
+            std::size_t capacity = std::max<std::size_t>(m_table.size(), MIN_TABLE_SIZE);
+            while (count * 4 > capacity * 3) {
+                capacity *= 2;
+            }
+            std::vector<Slot> table(capacity);
+            for (const Slot& slot : m_table) {
+                if (slot.id_plus_one != 0) {
+                    insert_slot(table, slot);
+                }
+            }
+            m_table = std::move(table);
+        }
+    }
+
+    /**
+     * @brief Applies a function to each (id, string) pair in id order.
+     *
+     * @tparam Func The type of the function to apply.
+     * @param func The function to apply.
+     */
+    template<typename Func>
+    void for_each_pair(Func&& func) const {
+        for (std::size_t id = 0; id < m_strings.size(); id++) {
+            std::invoke(func, static_cast<uint32_t>(id), view(m_strings[id]));
+        }
+    }
+
+    /**
+     * @brief Applies a function to each string in id order.
+     *
+     * @tparam Func The type of the function to apply.
+     * @param func The function to apply.
+     */
+    template<typename Func>
+    void for_each_string(Func&& func) const {
+        for (const char* str : m_strings) {
+            std::invoke(func, view(str));
+        }
+    }
+
+private:
+    /**
+     * @brief An index slot; id_plus_one is 0 for an empty slot.
+     */
+    struct Slot {
+        uint32_t hash;
+        uint32_t id_plus_one;
+    };
+
+    static constexpr std::size_t MIN_TABLE_SIZE = 16;
+    static constexpr std::size_t CHUNK_SIZE = 64 * 1024;
+    static constexpr std::size_t MIGRATE_SLOTS_PER_INSERT = 8;
+    static constexpr std::size_t BATCH_GROUP_SIZE = 16;
+
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    char* m_cursor = nullptr;
+    std::size_t m_remaining = 0;
+    std::size_t m_chunk_bytes = 0;
+
+    std::vector<const char*> m_strings; /**< Length-prefixed arena entries, indexed by id. */
+    std::vector<Slot> m_table;
+    std::vector<Slot> m_old; /**< Previous table while an incremental resize is running. */
+    std::size_t m_migrate_pos = 0;
+
+    static std::string_view view(const char* entry) noexcept {
+        uint32_t length;
+        std::memcpy(&length, entry, sizeof(length));
+        return {entry + sizeof(length), length};
+    }
+
+    const char* store(std::string_view value) {
+        std::size_t needed = sizeof(uint32_t) + value.size();
+        if (needed > m_remaining) {
+            std::size_t chunk_size = std::max(CHUNK_SIZE, needed);
+            m_chunks.push_back(std::make_unique_for_overwrite<char[]>(chunk_size));
+            m_cursor = m_chunks.back().get();
+            m_remaining = chunk_size;
+            m_chunk_bytes += chunk_size;
+        }
+        char* entry = m_cursor;
+        uint32_t length = static_cast<uint32_t>(value.size());
+        std::memcpy(entry, &length, sizeof(length));
+        std::memcpy(entry + sizeof(length), value.data(), value.size());
+        m_cursor += needed;
+        m_remaining -= needed;
+        return entry;
+    }
+
+    uint32_t probe(const std::vector<Slot>& table, std::string_view value, uint32_t h) const {
+        if (table.empty()) {
+            return npos;
+        }
+        std::size_t mask = table.size() - 1;
+        for (std::size_t i = h & mask; table[i].id_plus_one != 0; i = (i + 1) & mask) {
+            if (table[i].hash == h && view(m_strings[table[i].id_plus_one - 1]) == value) {
+                return table[i].id_plus_one - 1;
+            }
+        }
+        return npos;
+    }
+
+    uint32_t find_hashed(std::string_view value, uint32_t h) const {
+        uint32_t id = probe(m_table, value, h);
+        if (id == npos && !m_old.empty()) {
+            id = probe(m_old, value, h);
+        }
+        return id;
+    }
+
+    static void insert_slot(std::vector<Slot>& table, Slot slot) noexcept {
+        std::size_t mask = table.size() - 1;
+        std::size_t i = slot.hash & mask;
+        while (table[i].id_plus_one != 0) {
+            i = (i + 1) & mask;
+        }
+        table[i] = slot;
+    }
+
+    /**
+     * @brief Moves a bounded number of slots from the previous table.
+     *
+     * Growth happens at 3/4 load into a table twice as large, so at least
+     * 3/4 of the old capacity in insertions separates two growths; moving
+     * 8 slots per insertion always finishes well before the next one.
+     */
+    void migrate_step() {
+        if (m_old.empty()) {
+            return;
+        }
+        std::size_t end = std::min(m_old.size(), m_migrate_pos + MIGRATE_SLOTS_PER_INSERT);
+        for (; m_migrate_pos < end; m_migrate_pos++) {
+            if (m_old[m_migrate_pos].id_plus_one != 0) {
+                insert_slot(m_table, m_old[m_migrate_pos]);
+            }
+        }
+        if (m_migrate_pos == m_old.size()) {
+            std::vector<Slot>().swap(m_old);
+            m_migrate_pos = 0;
+        }
+    }
+
+    void finish_migration() {
+        while (!m_old.empty()) {
+            migrate_step();
+        }
+    }
+
+    void grow() {
+        finish_migration();
+        std::size_t capacity = std::max(m_table.size() * 2, MIN_TABLE_SIZE);
+        if (m_table.empty()) {
+            m_table.resize(capacity);
+            return;
+        }
+        m_old = std::move(m_table);
+        m_table = std::vector<Slot>(capacity);
+        m_migrate_pos = 0;
+    }
+}; // class StringInterner
+
+}; // namespace Topname
+
+#endif // TOPNAME_INTERNER_H
@@ -0,0 +1,243 @@
+#ifndef TOPNAME_LOOKUP_CACHE_H
+#define TOPNAME_LOOKUP_CACHE_H
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief An EnumString with a small per-thread cache in front of its string lookups.
+ *
+ * Real traffic is skewed: a handful of values make up most lookups. Each
+ * thread keeps Slots direct-mapped entries per lookup kind, one for to_enum()
+ * and one for to_enum_insensitive(), holding the looked up bytes and the
+ * result. A lookup first checks the slot that answered the previous one by
+ * (pointer, length), which catches a caller passing the same buffer again,
+ * then the slot picked by a hash of the length and the first and last eight
+ * bytes, which catches the same value arriving in a different buffer.
+ *
+ * Entries keep a copy of strings of at most MaxBytes bytes and every hit
+ * compares the input with it, so a cache hit never reads memory the caller
+ * may have freed and a reused buffer with new contents is never answered from
+ * a stale entry. Strings of up to 16 bytes are compared with two word loads.
+ * Longer strings and misses bypass the cache. Entries are tagged with the id
+ * of the owning instance, so tables of the same type never answer for each
+ * other.
+ *
+ * Hits are still reported to the instrumentation policy of the table.
+ *
+ * @tparam E Enum type.
+ * @tparam N The number of mappings.
+ * @tparam I The instrumentation policy of the table.
+ * @tparam Slots The number of entries per thread and lookup kind, a power of two.
+ * @tparam MaxBytes The longest string that is cached.
+ */
+template<EnumType E, std::size_t N, typename I = NoInstrumentation, std::size_t Slots = 8, std::size_t MaxBytes = 64>
+class CachedEnumString {
+    static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0, "Slots must be a power of two");
+    static_assert(MaxBytes <= UINT32_MAX, "MaxBytes must fit the length field");
+
+public:
+    /**
+     * @brief Wraps a copy of a table.
+     *
+     * @param table The table to serve lookups from.
+     */
+    explicit CachedEnumString(const EnumString<E, N, I>& table)
+    : m_table(table), m_id(next_id())
+    {}
+
+    CachedEnumString(const CachedEnumString&) = delete;
+    CachedEnumString& operator=(const CachedEnumString&) = delete;
+
+    /**
+     * @brief Converts a string to its corresponding enum value without throwing.
+     *
+     * @param value The string to convert.
+     * @return The corresponding enum value, or std::nullopt if the string is not mapped.
+     */
+    [[nodiscard]] std::optional<E> try_to_enum(std::string_view value) const {
+        return lookup<LookupOp::ToEnum>(value, [this](std::string_view v) { return m_table.try_to_enum(v); });
+    }
+
+    /**
+     * @brief Converts a string to its corresponding enum value.
+     *
+     * @param value The string to convert.
+     * @return The corresponding enum value.
+     * @throw InvalidStringValue If the string does not match any enum value.
+     */
+    [[nodiscard]] E to_enum(std::string_view value) const {
+        if (std::optional<E> found = try_to_enum(value)) {
+            return *found;
+        }
+        auto err = EnumStringException::ErrorCode::InvalidStringValue;
+        throw EnumStringException(err, "String value not found in the mapping");
+    }
+
+    /**
+     * @brief Converts a string to its corresponding enum value (case-insensitive).
+     *
+     * Entries are keyed by the exact bytes, so each spelling of a value takes
+     * a slot of its own.
+     *
+     * @param value The string to convert.
+     * @return The corresponding enum value.
+     * @throw InvalidStringValue If the string does not match any enum value.
+     */
+    [[nodiscard]] E to_enum_insensitive(std::string_view value) const {
+        return *lookup<LookupOp::ToEnumInsensitive>(value, [this](std::string_view v) {
+            return std::optional<E>(m_table.to_enum_insensitive(v));
+        });
+    }
+
+    /**
+     * @brief Drops the entries of the calling thread, for every instance of this type.
+     */
+    static void clear_thread_cache() noexcept {
+        state<LookupOp::ToEnum>() = {};
+        state<LookupOp::ToEnumInsensitive>() = {};
+    }
+
+    /**
+     * @brief Returns the wrapped table, e.g. for to_string().
+     */
+    [[nodiscard]] const EnumString<E, N, I>& table() const noexcept { return m_table; }
+
+private:
+    /**
+     * @brief The first and last eight bytes of a string, or overlapping smaller loads for short ones.
+     *
+     * Together with the length they cover every byte of strings of up to
+     * 16 bytes, so such strings are equal exactly when their Words are.
+     */
+    struct Words {
+        uint64_t head = 0;
+        uint64_t tail = 0;
+
+        bool operator==(const Words&) const = default;
+    };
+
+    struct Slot {
+        uint64_t owner = 0;           /**< Id of the instance that filled the slot, 0 if empty. */
+        const char* data = nullptr;   /**< Buffer of the last lookup answered here, compared but never read. */
+        Words words;
+        uint32_t length = 0;
+        E value{};
+        std::array<char, MaxBytes> bytes{}; /**< Copy of strings longer than 16 bytes, for the middle part. */
+    };
+
+    struct State {
+        std::array<Slot, Slots> slots{};
+        std::size_t last = 0; /**< The slot that answered the previous lookup. */
+    };
+
+    EnumString<E, N, I> m_table;
+    uint64_t m_id;
+
+    static uint64_t next_id() noexcept {
+        static std::atomic<uint64_t> counter{0};
+        return counter.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    template<LookupOp Op>
+    static State& state() noexcept {
+        thread_local State cache;
+        return cache;
+    }
+
+    static Words load_words(std::string_view value) noexcept {
+        const char* p = value.data();
+        std::size_t n = value.size();
+        Words w;
+        if (n >= 8) {
+            std::memcpy(&w.head, p, 8);
+            std::memcpy(&w.tail, p + n - 8, 8);
+        } else if (n >= 4) {
+            uint32_t head, tail;
+            std::memcpy(&head, p, 4);
+            std::memcpy(&tail, p + n - 4, 4);
+            w.head = head;
+            w.tail = tail;
+        } else if (n > 0) {
+            w.head = static_cast<unsigned char>(p[0])
+                   | static_cast<uint64_t>(static_cast<unsigned char>(p[n / 2])) << 8
+                   | static_cast<uint64_t>(static_cast<unsigned char>(p[n - 1])) << 16;
+        }
+        return w;
+    }
+
+    static std::size_t slot_index(const Words& w, std::size_t length) noexcept {
+        uint64_t mixed = (w.head ^ (w.tail * 0x9e3779b97f4a7c15ull)) + length;
+        return mix_hash(static_cast<uint32_t>(mixed ^ (mixed >> 32))) & (Slots - 1);
+    }
+
+    bool matches(const Slot& slot, std::string_view value, const Words& w) const noexcept {
+        return slot.owner == m_id && slot.length == value.size() && slot.words == w
+            && (value.size() <= 16 || std::memcmp(slot.bytes.data() + 8, value.data() + 8, value.size() - 16) == 0);
+    }
+
+    /**
+     * @brief Answers from the cache of the calling thread, or asks the table and remembers its answer.
+     *
+     * @param fallback Looks the string up in the table when the cache does not hold it.
+     */
+    template<LookupOp Op, typename Fallback>
+    std::optional<E> lookup(std::string_view value, const Fallback& fallback) const {
+        if (value.size() > MaxBytes) {
+            return fallback(value);
+        }
+        State& cache = state<Op>();
+        Words w = load_words(value);
+        Slot& last = cache.slots[cache.last];
+        if (last.data == value.data() && matches(last, value, w)) {
+            return report_hit<Op>(last.value);
+        }
+
+        std::size_t index = slot_index(w, value.size());
+        Slot& slot = cache.slots[index];
+        if (matches(slot, value, w)) {
+            slot.data = value.data();
+            cache.last = index;
+            return report_hit<Op>(slot.value);
+        }
+
+        std::optional<E> found = fallback(value);
+        if (found) {
+            slot.owner = m_id;
+            slot.data = value.data();
+            slot.words = w;
+            slot.length = static_cast<uint32_t>(value.size());
+            slot.value = *found;
+            if (value.size() > 16) {
+                std::memcpy(slot.bytes.data(), value.data(), value.size());
+            }
+            cache.last = index;
+        }
+        return found;
+    }
+
+    template<LookupOp Op>
+    static E report_hit(E value) {
+        typename I::Scope scope(Op);
+        scope.hit();
+        return value;
+    }
+}; // class CachedEnumString
+
+/**
+ * @brief Deduction guide to construct a CachedEnumString from an EnumString.
+ */
+template<EnumType E, std::size_t N, typename I>
+CachedEnumString(const EnumString<E, N, I>&) -> CachedEnumString<E, N, I>;
+
+}; // namespace Topname
+
+#endif // TOPNAME_LOOKUP_CACHE_H
@@ -0,0 +1,471 @@
+#ifndef TOPNAME_NAME_SCANNER_H
+#define TOPNAME_NAME_SCANNER_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief Whether NameScanner tells letters of different case apart.
+ */
+enum class MatchCase {
+    Sensitive,        /**< Bytes match only themselves. */
+    AsciiInsensitive, /**< 'A'-'Z' match 'a'-'z' and vice versa; other bytes match only themselves. */
+};
+
+/**
+ * @brief An occurrence of a string of the table, reported by NameScanner.
+ */
+template<EnumType E>
+struct NameMatch {
+    std::size_t position; /**< Offset of the first byte of the occurrence in the text. */
+    E value;              /**< The value of the string that occurs. */
+};
+
+/**
+ * @brief Folds an ASCII byte for matching, lowering 'A'-'Z' if the matching ignores case.
+ */
+template<MatchCase Case>
+constexpr unsigned char fold_byte(char ch) noexcept {
+    auto byte = static_cast<unsigned char>(ch);
+    if (Case == MatchCase::AsciiInsensitive && byte >= 'A' && byte <= 'Z') {
+        return static_cast<unsigned char>(byte - 'A' + 'a');
+    }
+    return byte;
+}
+
+/**
+ * @brief Estimates how common a byte is in log lines and other free text, in arbitrary units.
+ *
+ * Lower-case letters follow their frequency in English text, and upper-case
+ * letters are a quarter as common. Spaces, digits and the punctuation of
+ * paths, numbers and key=value pairs are common; other bytes are rare.
+ */
+constexpr int text_frequency(unsigned char byte) noexcept {
+    constexpr std::string_view by_frequency = "etaoinshrdlcumwfgypbvkjxqz";
+    if (byte >= 'a' && byte <= 'z') {
+        return 80 - 3 * static_cast<int>(by_frequency.find(static_cast<char>(byte)));
+    }
+    if (byte >= 'A' && byte <= 'Z') {
+        return text_frequency(static_cast<unsigned char>(byte - 'A' + 'a')) / 4;
+    }
+    if (byte == ' ') {
+        return 100;
+    }
+    if ((byte >= '0' && byte <= '9') || std::string_view(".,:;/-_=\"'()[]").find(static_cast<char>(byte)) !=
+                                            std::string_view::npos) {
+        return 30;
+    }
+    return 1;
+}
+
+/**
+ * @brief The non-empty strings of a table in folded byte order with their values; equal strings keep declaration order.
+ */
+template<const auto& Table, MatchCase Case>
+consteval auto scanner_strings() {
+    using E = std::remove_cvref_t<decltype(Table.to_enum(std::string_view{}))>;
+    constexpr std::size_t N = [] {
+        std::size_t count = 0;
+        Table.for_each_pair([&count](E, std::string_view str_val) { count += str_val.empty() ? 0 : 1; });
+        return count;
+    }();
+
+    struct Entry {
+        std::string_view string_val;
+        std::size_t order;
+        E enum_val;
+    };
+    std::array<Entry, N> entries{};
+    std::size_t i = 0;
+    Table.for_each_pair([&entries, &i](E enum_val, std::string_view str_val) {
+        if (!str_val.empty()) {
+            entries[i] = {str_val, i, enum_val};
+            i++;
+        }
+    });
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        bool less = std::lexicographical_compare(a.string_val.begin(), a.string_val.end(), b.string_val.begin(),
+                                                 b.string_val.end(), [](char x, char y) {
+            return fold_byte<Case>(x) < fold_byte<Case>(y);
+        });
+        bool greater = std::lexicographical_compare(b.string_val.begin(), b.string_val.end(), a.string_val.begin(),
+                                                    a.string_val.end(), [](char x, char y) {
+            return fold_byte<Case>(x) < fold_byte<Case>(y);
+        });
+        return less || (!greater && a.order < b.order);
+    });
+    return entries;
+}
+
+/**
+ * @brief Returns the length of the common prefix of two strings after folding.
+ */
+template<MatchCase Case>
+constexpr std::size_t folded_common_prefix(std::string_view a, std::string_view b) noexcept {
+    std::size_t common = 0;
+    while (common < a.size() && common < b.size() && fold_byte<Case>(a[common]) == fold_byte<Case>(b[common])) {
+        common++;
+    }
+    return common;
+}
+
+/**
+ * @brief Returns the number of states of the automaton of a table: state 0, unused, and one per distinct prefix.
+ */
+template<const auto& Table, MatchCase Case>
+consteval std::size_t scanner_states() {
+    std::size_t states = 2;
+    std::string_view previous;
+    for (const auto& entry : scanner_strings<Table, Case>()) {
+        states += entry.string_val.size() - folded_common_prefix<Case>(previous, entry.string_val);
+        previous = entry.string_val;
+    }
+    return states;
+}
+
+/**
+ * @brief Returns the number of byte classes of the automaton of a table: one per distinct folded byte, plus class 0.
+ */
+template<const auto& Table, MatchCase Case>
+consteval std::size_t scanner_classes() {
+    std::array<bool, 256> used{};
+    std::size_t classes = 1;
+    for (const auto& entry : scanner_strings<Table, Case>()) {
+        for (char ch : entry.string_val) {
+            unsigned char byte = fold_byte<Case>(ch);
+            classes += used[byte] ? 0 : 1;
+            used[byte] = true;
+        }
+    }
+    return classes;
+}
+
+/**
+ * @brief The Aho-Corasick automaton of a NameScanner, as built at compile time.
+ *
+ * @tparam E Enum type.
+ * @tparam States The number of states, including the unused state 0.
+ * @tparam Classes The number of byte classes, including class 0 for bytes in no string.
+ */
+template<EnumType E, std::size_t States, std::size_t Classes>
+struct ScannerAutomaton {
+    using State = std::conditional_t<States <= UINT8_MAX + 1, uint8_t,
+                  std::conditional_t<States <= UINT16_MAX + 1, uint16_t, uint32_t>>;
+
+    static constexpr State ROOT = 1;
+
+    /** @brief The most distinct rare bytes the SIMD prefilter compares against. */
+    static constexpr std::size_t MAX_RARE_BYTES = 8;
+
+    std::array<uint16_t, 256> classes{};        /**< Byte class of every byte. */
+    std::array<State, States * Classes> next{}; /**< Successor of a state by byte class, failure links resolved. */
+    std::array<E, States> values{};             /**< The value of the string ending in a state. */
+    std::array<uint32_t, States> lengths{};     /**< Length of the string ending in a state, 0 if none does. */
+    std::array<State, States> outputs{};        /**< Longest proper suffix state a string ends in, 0 if none. */
+    std::array<State, States> reports{};        /**< The state itself if a string ends in it, else outputs. */
+    std::array<bool, 256> rare{};               /**< Whether a byte is the rare byte of some string. */
+    std::array<char, MAX_RARE_BYTES> rare_bytes{};
+    std::size_t rare_count = 0;                 /**< Bytes in rare_bytes, or 0 if there are too many to compare. */
+    std::size_t rare_offset = 0;                /**< The largest offset of the rare byte in its string. */
+}; // struct ScannerAutomaton
+
+/**
+ * @brief Builds the Aho-Corasick automaton of the strings of a table.
+ *
+ * The trie of the folded strings is completed into a DFA: every missing
+ * transition is resolved through the failure links in breadth-first order,
+ * so scanning takes exactly one transition per byte.
+ */
+template<const auto& Table, MatchCase Case>
+consteval auto build_scanner_automaton() {
+    constexpr auto entries = scanner_strings<Table, Case>();
+    constexpr std::size_t STATES = scanner_states<Table, Case>();
+    constexpr std::size_t CLASSES = scanner_classes<Table, Case>();
+    using E = std::remove_cvref_t<decltype(Table.to_enum(std::string_view{}))>;
+    using Automaton = ScannerAutomaton<E, STATES, CLASSES>;
+    using State = typename Automaton::State;
+    constexpr State ROOT = Automaton::ROOT;
+
+    Automaton ac;
+    uint16_t next_class = 1;
+    for (const auto& entry : entries) {
+        for (char ch : entry.string_val) {
+            unsigned char byte = fold_byte<Case>(ch);
+            if (ac.classes[byte] == 0) {
+                ac.classes[byte] = next_class++;
+            }
+        }
+    }
+    if constexpr (Case == MatchCase::AsciiInsensitive) {
+        for (int byte = 'A'; byte <= 'Z'; byte++) {
+            ac.classes[byte] = ac.classes[byte - 'A' + 'a'];
+        }
+    }
+
+    // The trie, sharing the common prefix of consecutive sorted strings as StreamMatcher does.
+    std::array<State, Table.max_string_length() + 1> path{};
+    path[0] = ROOT;
+    std::size_t next_state = 2;
+    std::string_view previous;
+    for (const auto& entry : entries) {
+        std::string_view str = entry.string_val;
+        for (std::size_t k = folded_common_prefix<Case>(previous, str); k < str.size(); k++) {
+            auto state = static_cast<State>(next_state++);
+            ac.next[path[k] * CLASSES + ac.classes[static_cast<unsigned char>(str[k])]] = state;
+            path[k + 1] = state;
+        }
+        State end = path[str.size()];
+        if (ac.lengths[end] == 0) {
+            ac.lengths[end] = static_cast<uint32_t>(str.size());
+            ac.values[end] = entry.enum_val;
+        }
+        previous = str;
+    }
+
+    // Failure links in breadth-first order; a state's missing transitions are those of its failure state.
+    std::array<State, STATES> fail{};
+    std::array<State, STATES> queue{};
+    std::size_t head = 0;
+    std::size_t tail = 0;
+    for (std::size_t c = 0; c < CLASSES; c++) {
+        State child = ac.next[ROOT * CLASSES + c];
+        if (child == 0) {
+            ac.next[ROOT * CLASSES + c] = ROOT;
+        } else {
+            fail[child] = ROOT;
+            queue[tail++] = child;
+        }
+    }
+    while (head != tail) {
+        State state = queue[head++];
+        ac.outputs[state] = ac.lengths[fail[state]] != 0 ? fail[state] : ac.outputs[fail[state]];
+        ac.reports[state] = ac.lengths[state] != 0 ? state : ac.outputs[state];
+        for (std::size_t c = 0; c < CLASSES; c++) {
+            State child = ac.next[state * CLASSES + c];
+            State fallback = ac.next[fail[state] * CLASSES + c];
+            if (child == 0) {
+                ac.next[state * CLASSES + c] = fallback;
+            } else {
+                fail[child] = fallback;
+                queue[tail++] = child;
+            }
+        }
+    }
+
+    // Every string is given its least common byte, the first one of them if several tie.
+    for (const auto& entry : entries) {
+        std::string_view str = entry.string_val;
+        std::size_t best = 0;
+        int best_frequency = INT32_MAX;
+        for (std::size_t k = 0; k < str.size(); k++) {
+            int frequency = 0;
+            for (unsigned byte = 0; byte < 256; byte++) {
+                if (fold_byte<Case>(static_cast<char>(byte)) == fold_byte<Case>(str[k])) {
+                    frequency += text_frequency(static_cast<unsigned char>(byte));
+                }
+            }
+            if (frequency < best_frequency) {
+                best = k;
+                best_frequency = frequency;
+            }
+        }
+        for (unsigned byte = 0; byte < 256; byte++) {
+            if (fold_byte<Case>(static_cast<char>(byte)) == fold_byte<Case>(str[best])) {
+                ac.rare[byte] = true;
+            }
+        }
+        ac.rare_offset = std::max(ac.rare_offset, best);
+    }
+    for (unsigned byte = 0; byte < 256; byte++) {
+        if (!ac.rare[byte]) {
+            continue;
+        }
+        if (ac.rare_count == Automaton::MAX_RARE_BYTES) {
+            ac.rare_count = 0; // Too many to compare; scan without the prefilter.
+            break;
+        }
+        ac.rare_bytes[ac.rare_count++] = static_cast<char>(byte);
+    }
+    return ac;
+}
+
+/**
+ * @brief Finds every occurrence of the strings of a table in free text in one pass.
+ *
+ * Replaces a find() per string with an Aho-Corasick automaton built at
+ * compile time from a constexpr table. The trie of the strings is completed
+ * into a DFA with compressed byte classes, so the scan takes one table load
+ * per byte of text, whatever the number of strings, and reports overlapping
+ * occurrences too. With MatchCase::AsciiInsensitive the strings are folded
+ * when the automaton is built and upper-case bytes share the class of their
+ * lower-case counterparts, so the scan itself does no case folding.
+ *
+ * Most of the text is usually far from any occurrence. Every string is
+ * given its rarest byte by text_frequency(), and while the automaton is in
+ * its root state the scan skips ahead with SSE2 to the next rare byte,
+ * comparing 16 bytes at a time with each of them. It resumes the automaton
+ * as far before that byte as the rare byte can lie in its string, so no
+ * occurrence is missed. This needs at most MAX_RARE_BYTES distinct rare
+ * bytes, counting both cases of letters when case is ignored; with more,
+ * the automaton runs on every byte.
+ *
+ * Occurrences are reported in order of their last byte, longer ones first
+ * when several end at the same byte. Strings that occur in the table more
+ * than once (after folding) report the first declared value, and the empty
+ * string is never reported. Scans are not reported to the instrumentation
+ * policy.
+ *
+ * @code
+ * constexpr auto levels = EnumString(Level::Warn, "WARN", Level::Error, "ERROR");
+ * NameScanner<levels> scanner;
+ * scanner.find_all("12:00 ERROR disk full"); // {{6, Level::Error}}
+ * @endcode
+ *
+ * @tparam Table An EnumString with static storage duration.
+ * @tparam Case Whether letters of different case match each other.
+ */
+template<const auto& Table, MatchCase Case = MatchCase::Sensitive>
+class NameScanner {
+    static constexpr auto AC = build_scanner_automaton<Table, Case>();
+    using Automaton = std::remove_cvref_t<decltype(AC)>;
+
+public:
+    using Enum = std::remove_cvref_t<decltype(Table.to_enum(std::string_view{}))>;
+    using State = typename Automaton::State;
+
+    /** @brief The number of states, including the unused state 0. */
+    static constexpr std::size_t STATES = AC.lengths.size();
+    /** @brief The number of byte classes, including the class of bytes in no string. */
+    static constexpr std::size_t CLASSES = AC.next.size() / STATES;
+    /** @brief The most distinct rare bytes for which the SIMD prefilter is used. */
+    static constexpr std::size_t MAX_RARE_BYTES = Automaton::MAX_RARE_BYTES;
+
+    /**
+     * @brief Calls a function with every occurrence of a string of the table in a text.
+     *
+     * @param text The text to scan.
+     * @param func Called as func(position, value) for every occurrence.
+     */
+    template<typename Func>
+    constexpr void for_each_match(std::string_view text, Func&& func) const {
+        const char* const begin = text.data();
+        const char* const end = begin + text.size();
+        State state = Automaton::ROOT;
+        for (const char* p = begin; p != end; p++) {
+            if (PREFILTER && state == Automaton::ROOT) {
+                p = skip_to_rare(p, end);
+                if (p == end) {
+                    break;
+                }
+            }
+            state = AC.next[state * CLASSES + AC.classes[static_cast<unsigned char>(*p)]];
+            for (State found = AC.reports[state]; found != 0; found = AC.outputs[found]) {
+                auto last = static_cast<std::size_t>(p - begin);
+                func(last + 1 - AC.lengths[found], AC.values[found]);
+            }
+        }
+    }
+
+    /**
+     * @brief Returns every occurrence of a string of the table in a text, in the order for_each_match() reports them.
+     */
+    [[nodiscard]] std::vector<NameMatch<Enum>> find_all(std::string_view text) const {
+        std::vector<NameMatch<Enum>> matches;
+        for_each_match(text, [&matches](std::size_t position, Enum value) {
+            matches.push_back({position, value});
+        });
+        return matches;
+    }
+
+    /**
+     * @brief Returns whether any string of the table occurs in a text, stopping at the first occurrence.
+     */
+    [[nodiscard]] constexpr bool contains_any(std::string_view text) const noexcept {
+        const char* const end = text.data() + text.size();
+        State state = Automaton::ROOT;
+        for (const char* p = text.data(); p != end; p++) {
+            if (PREFILTER && state == Automaton::ROOT) {
+                p = skip_to_rare(p, end);
+                if (p == end) {
+                    break;
+                }
+            }
+            state = AC.next[state * CLASSES + AC.classes[static_cast<unsigned char>(*p)]];
+            if (AC.reports[state] != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Returns the number of distinct rare bytes the SIMD prefilter looks for, or 0 if it is not used.
+     */
+    [[nodiscard]] static constexpr std::size_t prefilter_bytes() noexcept {
+        return PREFILTER ? AC.rare_count : 0;
+    }
+
+    /**
+     * @brief Returns the bytes of the automaton shared by all scanners of this table.
+     */
+    [[nodiscard]] static constexpr std::size_t table_bytes() noexcept {
+        return sizeof(AC);
+    }
+
+private:
+#if defined(__SSE2__)
+    /** @brief Whether there are few enough rare bytes to skip the text between them with SSE2. */
+    static constexpr bool PREFILTER = AC.rare_count != 0;
+#else
+    static constexpr bool PREFILTER = false;
+#endif
+
+    /**
+     * @brief Returns the first byte from p on at which an occurrence can start, or end if none can.
+     *
+     * That is rare_offset bytes before the next rare byte, but not before p.
+     */
+    static constexpr const char* skip_to_rare(const char* p, const char* end) noexcept {
+        const char* rare = p;
+#if defined(__SSE2__)
+        if (!std::is_constant_evaluated()) {
+            for (; end - rare >= 16; rare += 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rare));
+                __m128i hits = _mm_setzero_si128();
+                for (std::size_t i = 0; i < AC.rare_count; i++) {
+                    hits = _mm_or_si128(hits, _mm_cmpeq_epi8(block, _mm_set1_epi8(AC.rare_bytes[i])));
+                }
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+                if (mask != 0) {
+                    rare += std::countr_zero(mask);
+                    return static_cast<std::size_t>(rare - p) > AC.rare_offset ? rare - AC.rare_offset : p;
+                }
+            }
+        }
+#endif
+        while (rare != end && !AC.rare[static_cast<unsigned char>(*rare)]) {
+            rare++;
+        }
+        if (rare == end) {
+            return end;
+        }
+        return static_cast<std::size_t>(rare - p) > AC.rare_offset ? rare - AC.rare_offset : p;
+    }
+}; // class NameScanner
+
+}; // namespace Topname
+
+#endif // TOPNAME_NAME_SCANNER_H
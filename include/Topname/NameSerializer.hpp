@@ -0,0 +1,512 @@
+#ifndef TOPNAME_NAME_SERIALIZER_H
+#define TOPNAME_NAME_SERIALIZER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if __has_include(<sys/uio.h>)
+#include <sys/uio.h>
+#endif
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief Writes whole arrays of enum values as delimited text, e.g. a CSV or TSV column.
+ *
+ * Keeps the string of every distinct value of an EnumString in one pool,
+ * followed by CHUNK bytes of padding, and a length per value. A bulk write
+ * first adds up the lengths of all values to check the output size, then
+ * copies every name in fixed CHUNK-byte blocks. Such copies compile to a
+ * few vector loads and stores, with no call and no branch on the length.
+ * They may write past the end of a name, so the delimiter or the next name
+ * is written over the excess; only the last few values, where the excess
+ * could leave the output, are copied exactly.
+ *
+ * The pool also holds every name as a JSON string, quoted and escaped when
+ * the serializer is built, so JSON output needs no escaping at runtime:
+ * to_json_fragment() returns it as one view and write_json() writes whole
+ * arrays of them the same way write_names() writes names.
+ *
+ * Where <sys/uio.h> is available, name_iovecs() and json_iovecs() describe
+ * the output as iovec segments pointing into the pool and at caller-owned
+ * separators instead of copying anything, for writev() or io_uring. Names
+ * are stored in value order ahead of the JSON fragments, so the names of
+ * consecutive values are adjacent and merge into one segment.
+ *
+ * Enum values are mapped to their pool entry through a dense array indexed
+ * by the underlying value when the values are compact, otherwise through a
+ * sorted array. Each value is written as to_string() of the table would
+ * return it. Writes are not reported to the instrumentation policy.
+ *
+ * @code
+ * NameSerializer names(color_names);
+ * std::vector<char> out(names.formatted_size(column, ','));
+ * names.write_names(column, ',', out); // Red,Green,Red
+ * names.to_json_fragment(Color::Red);  // "Red", with the quotes
+ * @endcode
+ *
+ * @tparam E Enum type.
+ */
+template<EnumType E>
+class NameSerializer {
+public:
+    /** @brief Width of the block copies; the pool holds this many bytes after its last name. */
+    static constexpr std::size_t CHUNK = 16;
+
+    /**
+     * @brief Copies the strings of a table and their JSON fragments into the pool.
+     *
+     * @tparam N The number of mappings.
+     * @tparam I The instrumentation policy of the table.
+     * @param table The table whose strings are written.
+     */
+    template<std::size_t N, typename I>
+    explicit NameSerializer(const EnumString<E, N, I>& table) {
+        std::vector<E> values;
+        values.reserve(N);
+        table.for_each_enum([&values](E enum_val) {
+            values.push_back(enum_val);
+        });
+        std::sort(values.begin(), values.end(), [](E a, E b) {
+            return enum_to_underlying(a) < enum_to_underlying(b);
+        });
+        values.erase(std::unique(values.begin(), values.end()), values.end());
+
+        std::vector<Entry> entries(values.size());
+        for (std::size_t i = 0; i < values.size(); i++) {
+            std::string_view str = table.to_string(values[i]);
+            entries[i].name = {static_cast<uint32_t>(m_pool.size()), static_cast<uint32_t>(str.size())};
+            m_pool.insert(m_pool.end(), str.begin(), str.end());
+            m_max_length = std::max(m_max_length, str.size());
+        }
+        for (std::size_t i = 0; i < values.size(); i++) {
+            Piece& json = entries[i].json;
+            json.offset = static_cast<uint32_t>(m_pool.size());
+            append_json_string(table.to_string(values[i]));
+            json.length = static_cast<uint32_t>(m_pool.size() - json.offset);
+            m_max_json_length = std::max(m_max_json_length, std::size_t{json.length});
+        }
+        m_pool.resize(m_pool.size() + CHUNK, '\0');
+        build_enum_index(values, entries);
+    }
+
+    /**
+     * @brief Returns the exact number of characters write_names() produces.
+     *
+     * Time complexity: O(values.size()), one index load per value.
+     *
+     * @param values The enum values to write.
+     * @param delimiter The character between names.
+     * @return The sum of the name lengths plus one delimiter between each two names.
+     * @throw InvalidEnumValue If a value does not match any string.
+     */
+    [[nodiscard]] std::size_t formatted_size(std::span<const E> values, char delimiter) const {
+        (void)delimiter; // Always one character; taken so that calls mirror write_names().
+        return joined_size<&Entry::name>(values);
+    }
+
+    /**
+     * @brief Writes the names of enum values separated by a delimiter.
+     *
+     * The output is sized before anything is written, so an unknown value or
+     * a short buffer leaves it untouched. No delimiter follows the last name
+     * and no terminator is appended.
+     *
+     * @param values The enum values to write.
+     * @param delimiter The character between names, e.g. ',' or '\n'.
+     * @param out Destination with room for at least formatted_size(values, delimiter) characters.
+     * @return The number of characters written.
+     * @throw InvalidEnumValue If a value does not match any string.
+     * @throw OutOfRange If out is too short.
+     */
+    std::size_t write_names(std::span<const E> values, char delimiter, std::span<char> out) const {
+        return write_joined<&Entry::name>(values, delimiter, out, m_max_length);
+    }
+
+    /**
+     * @brief Writes the names of enum values into a string allocated once at its exact size.
+     *
+     * @throw InvalidEnumValue If a value does not match any string.
+     */
+    [[nodiscard]] std::string to_string(std::span<const E> values, char delimiter) const {
+        std::string out(formatted_size(values, delimiter), '\0');
+        write_names(values, delimiter, out);
+        return out;
+    }
+
+    /**
+     * @brief Returns the JSON string of an enum value, including the quotes.
+     *
+     * Quotes, backslashes and control characters were escaped when the
+     * serializer was built; other bytes, including UTF-8 sequences, are kept.
+     *
+     * @param value The enum value to convert.
+     * @return A view into the pool, valid for the lifetime of the serializer.
+     * @throw InvalidEnumValue If the enum value does not match any string.
+     */
+    [[nodiscard]] std::string_view to_json_fragment(E value) const {
+        const Entry* entry = index().find(value);
+        if (entry == nullptr) {
+            throw_invalid_value();
+        }
+        return {m_pool.data() + entry->json.offset, entry->json.length};
+    }
+
+    /**
+     * @brief Returns the exact number of characters write_json() produces.
+     *
+     * @throw InvalidEnumValue If a value does not match any string.
+     */
+    [[nodiscard]] std::size_t json_size(std::span<const E> values, char delimiter) const {
+        (void)delimiter;
+        return joined_size<&Entry::json>(values);
+    }
+
+    /**
+     * @brief Writes the JSON strings of enum values separated by a delimiter.
+     *
+     * With ',' as the delimiter this is the inside of a JSON array; the
+     * caller writes the brackets. Sizing and block copies work as in
+     * write_names().
+     *
+     * @param values The enum values to write.
+     * @param delimiter The character between the strings.
+     * @param out Destination with room for at least json_size(values, delimiter) characters.
+     * @return The number of characters written.
+     * @throw InvalidEnumValue If a value does not match any string.
+     * @throw OutOfRange If out is too short.
+     */
+    std::size_t write_json(std::span<const E> values, char delimiter, std::span<char> out) const {
+        return write_joined<&Entry::json>(values, delimiter, out, m_max_json_length);
+    }
+
+#if __has_include(<sys/uio.h>)
+    /**
+     * @brief How much of a span of values a call to name_iovecs() or json_iovecs() described.
+     */
+    struct IovecBatch {
+        std::size_t values = 0;   /**< Values consumed; continue with the rest in another call. */
+        std::size_t segments = 0; /**< Entries of the output used. */
+        std::size_t bytes = 0;    /**< Total length of the segments. */
+    };
+
+    /**
+     * @brief Describes the names of enum values and their separators as iovec segments, without copying.
+     *
+     * Value i is followed by separators[i % separators.size()], so {",", "\n"}
+     * writes records of two fields, and an empty span writes the names back to
+     * back. Zero-length pieces are skipped and a segment that starts where the
+     * previous one ends extends it instead of taking an entry.
+     *
+     * Values are consumed whole: when the output is full, the batch stops
+     * before the first value whose name and separator do not both fit, so
+     * writev() with a batch never ends inside a record field; an output of
+     * at least two entries always makes progress. Segments point
+     * into the pool and into the separator buffers, which must stay valid
+     * until the write completes.
+     *
+     * @param values The enum values to describe.
+     * @param separators Caller-owned separators, used in turn after each value.
+     * @param out Receives the segments, e.g. IOV_MAX entries.
+     * @return The number of values consumed, segments used and bytes described.
+     * @throw InvalidEnumValue If a value does not match any string; out then holds the segments
+     *        of the values before it.
+     */
+    IovecBatch name_iovecs(std::span<const E> values, std::span<const std::string_view> separators,
+                           std::span<iovec> out) const {
+        return fill_iovecs<&Entry::name>(values, separators, out);
+    }
+
+    /**
+     * @brief Describes the JSON strings of enum values and their separators as iovec segments.
+     *
+     * Works like name_iovecs(), pointing at the quoted and escaped fragments.
+     *
+     * @throw InvalidEnumValue If a value does not match any string.
+     */
+    IovecBatch json_iovecs(std::span<const E> values, std::span<const std::string_view> separators,
+                           std::span<iovec> out) const {
+        return fill_iovecs<&Entry::json>(values, separators, out);
+    }
+#endif
+
+    /**
+     * @brief Returns the length of the longest string.
+     */
+    [[nodiscard]] std::size_t max_string_length() const noexcept { return m_max_length; }
+
+    /**
+     * @brief Returns the number of bytes held by the pool and the index.
+     */
+    [[nodiscard]] std::size_t memory_usage() const noexcept {
+        return m_pool.capacity() + m_dense.capacity() * sizeof(Entry)
+             + m_sorted.capacity() * sizeof(std::pair<E, Entry>);
+    }
+
+private:
+    struct Piece {
+        uint32_t offset = 0;
+        uint32_t length = MISSING; /**< MISSING for dense slots without a value. */
+    };
+
+    struct Entry {
+        Piece name;
+        Piece json; /**< The name quoted and escaped. */
+    };
+
+    static constexpr uint32_t MISSING = static_cast<uint32_t>(-1);
+
+    std::vector<char> m_pool;                    /**< The names, the JSON strings, then CHUNK bytes of padding. */
+    std::vector<Entry> m_dense;                  /**< Entry by underlying value - m_enum_min, if compact. */
+    std::vector<std::pair<E, Entry>> m_sorted;   /**< Entries sorted by value, otherwise. */
+    std::underlying_type_t<E> m_enum_min{};
+    std::size_t m_max_length = 0;
+    std::size_t m_max_json_length = 0;
+
+    /**
+     * @brief Adds up one piece of every value plus the delimiters between them.
+     */
+    template<Piece Entry::*Field>
+    std::size_t joined_size(std::span<const E> values) const {
+        if (values.empty()) {
+            return 0;
+        }
+        const Index index = this->index();
+        std::size_t size = values.size() - 1;
+        for (E value : values) {
+            const Entry* entry = index.find(value);
+            if (entry == nullptr) {
+                throw_invalid_value();
+            }
+            size += (entry->*Field).length;
+        }
+        return size;
+    }
+
+    /**
+     * @brief Sizes the output, then writes one piece of every value separated by a delimiter.
+     *
+     * @param max_length The longest piece, bounding the over-copy.
+     */
+    template<Piece Entry::*Field>
+    std::size_t write_joined(std::span<const E> values, char delimiter, std::span<char> out,
+                             std::size_t max_length) const {
+        std::size_t size = joined_size<Field>(values);
+        if (out.size() < size) {
+            auto err = EnumStringException::ErrorCode::OutOfRange;
+            throw EnumStringException(err, "Output span is shorter than the formatted names");
+        }
+
+        // Every value was found while sizing, so the copy loops resolve them without checks.
+        const Index index = this->index();
+        if (index.dense_size != 0) {
+            copy_pieces(values, delimiter, out.data(), size, max_length, [index](E value) {
+                return index.dense[enum_offset(value, index.enum_min)].*Field;
+            });
+        } else {
+            copy_pieces(values, delimiter, out.data(), size, max_length, [index](E value) {
+                return index.find(value)->*Field;
+            });
+        }
+        return size;
+    }
+
+    /**
+     * @brief Writes the pieces of values known to have one, with exactly size characters in total.
+     *
+     * While a block copy of the longest piece and a delimiter fits, pieces
+     * are copied in whole CHUNK-byte blocks; the pool padding keeps the reads
+     * in bounds. The tail, where an over-copy could leave the output, is exact.
+     *
+     * @param resolve Returns the piece of a value.
+     */
+    template<typename Resolve>
+    void copy_pieces(std::span<const E> values, char delimiter, char* out, std::size_t size, std::size_t max_length,
+                     const Resolve& resolve) const noexcept {
+        const char* pool = m_pool.data();
+        char* p = out;
+        char* end = out + size;
+        const std::size_t reach = std::max((max_length + CHUNK - 1) / CHUNK * CHUNK, CHUNK) + 1;
+        std::size_t i = 0;
+        for (; i < values.size() && static_cast<std::size_t>(end - p) >= reach; i++) {
+            const Piece piece = resolve(values[i]);
+            const char* src = pool + piece.offset;
+            std::memcpy(p, src, CHUNK);
+            for (std::size_t copied = CHUNK; copied < piece.length; copied += CHUNK) {
+                std::memcpy(p + copied, src + copied, CHUNK);
+            }
+            p += piece.length;
+            *p++ = delimiter;
+        }
+        for (; i < values.size(); i++) {
+            const Piece piece = resolve(values[i]);
+            std::memcpy(p, pool + piece.offset, piece.length);
+            p += piece.length;
+            if (p != end) {
+                *p++ = delimiter;
+            }
+        }
+    }
+
+#if __has_include(<sys/uio.h>)
+    /**
+     * @brief Appends a segment to out, extending the last one when it ends where the segment starts.
+     *
+     * @return False if a new entry was needed and out is full.
+     */
+    static bool append_segment(std::span<iovec> out, std::size_t& used, const char* base, std::size_t length) noexcept {
+        if (length == 0) {
+            return true;
+        }
+        if (used > 0 && static_cast<const char*>(out[used - 1].iov_base) + out[used - 1].iov_len == base) {
+            out[used - 1].iov_len += length;
+            return true;
+        }
+        if (used == out.size()) {
+            return false;
+        }
+        out[used++] = {const_cast<char*>(base), length}; // writev() does not write through iov_base.
+        return true;
+    }
+
+    template<Piece Entry::*Field>
+    IovecBatch fill_iovecs(std::span<const E> values, std::span<const std::string_view> separators,
+                           std::span<iovec> out) const {
+        const Index index = this->index();
+        const char* pool = m_pool.data();
+        IovecBatch batch;
+        for (; batch.values < values.size(); batch.values++) {
+            const Entry* entry = index.find(values[batch.values]);
+            if (entry == nullptr) {
+                throw_invalid_value();
+            }
+            const Piece piece = entry->*Field;
+            std::string_view separator = separators.empty()
+                ? std::string_view() : separators[batch.values % separators.size()];
+
+            // Undo a half-added value, including the growth of a merged segment.
+            std::size_t used = batch.segments;
+            std::size_t last_length = used > 0 ? out[used - 1].iov_len : 0;
+            if (!append_segment(out, used, pool + piece.offset, piece.length)
+                || !append_segment(out, used, separator.data(), separator.size())) {
+                if (batch.segments > 0) {
+                    out[batch.segments - 1].iov_len = last_length;
+                }
+                break;
+            }
+            batch.segments = used;
+            batch.bytes += piece.length + separator.size();
+        }
+        return batch;
+    }
+#endif
+
+    /**
+     * @brief Appends a string to the pool as a JSON string (RFC 8259).
+     */
+    void append_json_string(std::string_view str) {
+        constexpr std::string_view hex = "0123456789abcdef";
+        m_pool.push_back('"');
+        for (char ch : str) {
+            auto byte = static_cast<unsigned char>(ch);
+            if (ch == '"' || ch == '\\') {
+                m_pool.push_back('\\');
+                m_pool.push_back(ch);
+            } else if (byte >= 0x20) {
+                m_pool.push_back(ch);
+            } else if (ch == '\n' || ch == '\r' || ch == '\t' || ch == '\b' || ch == '\f') {
+                m_pool.push_back('\\');
+                m_pool.push_back(ch == '\n' ? 'n' : ch == '\r' ? 'r' : ch == '\t' ? 't' : ch == '\b' ? 'b' : 'f');
+            } else {
+                const char escape[] = {'\\', 'u', '0', '0', hex[byte >> 4], hex[byte & 0xf]};
+                m_pool.insert(m_pool.end(), escape, escape + sizeof(escape));
+            }
+        }
+        m_pool.push_back('"');
+    }
+
+    void build_enum_index(const std::vector<E>& values, const std::vector<Entry>& entries) {
+        if (values.empty()) {
+            return;
+        }
+        m_enum_min = enum_to_underlying(values.front());
+        uint64_t span = enum_offset(values.back(), m_enum_min);
+
+        if (span < 2 * values.size() + 64) {
+            m_dense.assign(span + 1, Entry{});
+            for (std::size_t i = 0; i < values.size(); i++) {
+                m_dense[enum_offset(values[i], m_enum_min)] = entries[i];
+            }
+            return;
+        }
+
+        m_sorted.reserve(values.size());
+        for (std::size_t i = 0; i < values.size(); i++) {
+            m_sorted.emplace_back(values[i], entries[i]);
+        }
+    }
+
+    /**
+     * @brief The index by value, copied out of the vectors into locals by the bulk loops.
+     *
+     * Stores through the char output may alias any member, so reading the
+     * index through this would reload it for every value.
+     */
+    struct Index {
+        const Entry* dense;
+        std::size_t dense_size;
+        const std::pair<E, Entry>* sorted;
+        std::size_t sorted_size;
+        std::underlying_type_t<E> enum_min;
+
+        /**
+         * @brief Returns the entry of a value, or nullptr if it has no string.
+         */
+        const Entry* find(E value) const noexcept {
+            auto underlying = enum_to_underlying(value);
+            if (dense_size != 0) {
+                if (underlying < enum_min) {
+                    return nullptr;
+                }
+                uint64_t offset = enum_offset(value, enum_min);
+                if (offset >= dense_size || dense[offset].name.length == MISSING) {
+                    return nullptr;
+                }
+                return &dense[offset];
+            }
+            const auto* it = std::lower_bound(sorted, sorted + sorted_size, underlying,
+                [](const auto& pair, auto key) { return enum_to_underlying(pair.first) < key; });
+            if (it == sorted + sorted_size || it->first != value) {
+                return nullptr;
+            }
+            return &it->second;
+        }
+    };
+
+    Index index() const noexcept {
+        return {m_dense.data(), m_dense.size(), m_sorted.data(), m_sorted.size(), m_enum_min};
+    }
+
+    [[noreturn]] static void throw_invalid_value() {
+        auto err = EnumStringException::ErrorCode::InvalidEnumValue;
+        throw EnumStringException(err, "Enum value not found in the mapping");
+    }
+}; // class NameSerializer
+
+/**
+ * @brief Deduction guide to construct a NameSerializer from an EnumString.
+ */
+template<EnumType E, std::size_t N, typename I>
+NameSerializer(const EnumString<E, N, I>&) -> NameSerializer<E>;
+
+}; // namespace Topname
+
+#endif // TOPNAME_NAME_SERIALIZER_H
@@ -0,0 +1,392 @@
+#ifndef TOPNAME_RELOADABLE_TABLE_H
+#define TOPNAME_RELOADABLE_TABLE_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief A file-backed display-name and alias table that can be reloaded at runtime.
+ *
+ * The compile-time EnumString acts as the schema: every line of the file refers
+ * to one of its canonical strings and lists the names that should be used for it.
+ *
+ * @code
+ * # canonical = display name[, alias...]
+ * Earth = Terra, Blue Planet
+ * Mars  = Red Planet
+ * @endcode
+ *
+ * The first name is the display name returned by to_string(), every name (and the
+ * canonical string itself) is accepted by to_enum(). Enum values without a line
+ * keep their canonical string.
+ *
+ * Each reload parses the file and builds a complete immutable snapshot on the
+ * reloading thread, then publishes it with a single atomic pointer store. Lookups
+ * only perform an acquire load and never take a lock, so a reload can not stall
+ * them. Replaced snapshots are retired rather than freed: string views returned
+ * by to_string() stay valid until reclaim() is called at a quiescent point.
+ *
+ * @tparam E Enum type.
+ * @tparam N The number of mappings in the schema table.
+ */
+template<EnumType E, std::size_t N>
+class ReloadableEnumString {
+public:
+    /**
+     * @brief An immutable version of the table published by a single reload.
+     */
+    class Snapshot {
+    private:
+        friend class ReloadableEnumString;
+
+        std::string m_storage; /**< Owns the characters of every name in this snapshot. */
+        std::vector<std::pair<E, std::string_view>> m_display; /**< Sorted by underlying value. */
+        std::unordered_map<std::string_view, E> m_lookup;
+        uint64_t m_generation = 0;
+
+        static constexpr bool enum_less(const std::pair<E, std::string_view>& a,
+                                        const std::pair<E, std::string_view>& b) {
+            return enum_to_underlying(a.first) < enum_to_underlying(b.first);
+        }
+
+    public:
+        /**
+         * @brief Converts a string (display name, alias or canonical string) to its enum value.
+         *
+         * @param value The string to convert.
+         * @return The corresponding enum value.
+         * @throw InvalidStringValue If the string does not match any enum value.
+         */
+        [[nodiscard]] E to_enum(std::string_view value) const {
+            auto it = m_lookup.find(value);
+            if (it == m_lookup.end()) {
+                auto err = EnumStringException::ErrorCode::InvalidStringValue;
+                throw EnumStringException(err, "String value not found in the mapping");
+            }
+            return it->second;
+        }
+
+        /**
+         * @brief Converts an enum value to its current display name.
+         *
+         * @param value The enum value to convert.
+         * @return The display name, backed by this snapshot's storage.
+         * @throw InvalidEnumValue If the enum value does not match any string.
+         */
+        [[nodiscard]] std::string_view to_string(E value) const {
+            std::pair<E, std::string_view> key{value, {}};
+            auto it = std::lower_bound(m_display.begin(), m_display.end(), key, enum_less);
+            if (it == m_display.end() || it->first != value) {
+                auto err = EnumStringException::ErrorCode::InvalidEnumValue;
+                throw EnumStringException(err, "Enum value not found in the mapping");
+            }
+            return it->second;
+        }
+
+        /**
+         * @brief Checks if a given string resolves to an enum value in this snapshot.
+         */
+        [[nodiscard]] bool contains(std::string_view target) const {
+            return m_lookup.find(target) != m_lookup.end();
+        }
+
+        /**
+         * @brief Returns the number of successful reloads that preceded this snapshot.
+         */
+        [[nodiscard]] uint64_t generation() const noexcept { return m_generation; }
+    };
+
+    /**
+     * @brief Constructs the table and performs the initial load.
+     *
+     * @param schema The compile-time table providing the canonical strings.
+     * @param path The file with display names and aliases.
+     * @throw FileReadError If the file can not be read.
+     * @throw ParseError If the file contains an invalid line.
+     */
+    template<typename I>
+    ReloadableEnumString(const EnumString<E, N, I>& schema, std::filesystem::path path)
+    : m_schema(schema.template with_instrumentation<NoInstrumentation>()), m_path(std::move(path))
+    {
+        reload();
+    }
+
+    ReloadableEnumString(const ReloadableEnumString&) = delete;
+    ReloadableEnumString& operator=(const ReloadableEnumString&) = delete;
+
+    ~ReloadableEnumString() {
+        delete m_current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Returns the snapshot currently published.
+     *
+     * The pointer stays valid until reclaim() is called after it was replaced.
+     */
+    [[nodiscard]] const Snapshot* snapshot() const noexcept {
+        return m_current.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Converts a string to its enum value using the current snapshot.
+     *
+     * @throw InvalidStringValue If the string does not match any enum value.
+     */
+    [[nodiscard]] E to_enum(std::string_view value) const {
+        return snapshot()->to_enum(value);
+    }
+
+    /**
+     * @brief Converts an enum value to its display name using the current snapshot.
+     *
+     * The returned view stays valid across reloads until reclaim() is called.
+     *
+     * @throw InvalidEnumValue If the enum value does not match any string.
+     */
+    [[nodiscard]] std::string_view to_string(E value) const {
+        return snapshot()->to_string(value);
+    }
+
+    /**
+     * @brief Checks if a given string resolves to an enum value in the current snapshot.
+     */
+    [[nodiscard]] bool contains(std::string_view target) const {
+        return snapshot()->contains(target);
+    }
+
+    /**
+     * @brief Asks for a reload on the next call to poll().
+     *
+     * Only stores an atomic flag, so it is safe to call from a signal handler
+     * (for example on SIGHUP).
+     */
+    void request_reload() noexcept {
+        m_reload_requested.store(true, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Reloads the file if a reload was requested or its modification time changed.
+     *
+     * Meant to be called periodically from a maintenance or watcher thread.
+     * On failure the current snapshot stays published.
+     *
+     * @return True if a new snapshot was published.
+     * @throw FileReadError If the file can not be read.
+     * @throw ParseError If the file contains an invalid line.
+     */
+    bool poll() {
+        bool requested = m_reload_requested.exchange(false, std::memory_order_relaxed);
+        std::error_code ec;
+        auto write_time = std::filesystem::last_write_time(m_path, ec);
+        {
+            std::lock_guard<std::mutex> lock(m_reload_mutex);
+            if (!requested && !ec && write_time == m_last_write) {
+                return false;
+            }
+        }
+        reload();
+        return true;
+    }
+
+    /**
+     * @brief Reads and parses the file, then atomically publishes the new snapshot.
+     *
+     * All parsing and index building happens before the swap; lookups running
+     * concurrently keep using the previous snapshot until the store is visible.
+     *
+     * @throw FileReadError If the file can not be read.
+     * @throw ParseError If the file contains an invalid line.
+     */
+    void reload() {
+        std::error_code ec;
+        auto write_time = std::filesystem::last_write_time(m_path, ec);
+        std::unique_ptr<Snapshot> next = build_snapshot(read_file());
+
+        std::lock_guard<std::mutex> lock(m_reload_mutex);
+        next->m_generation = m_generation++;
+        const Snapshot* previous = m_current.exchange(next.release(), std::memory_order_acq_rel);
+        if (previous != nullptr) {
+            m_retired.emplace_back(previous);
+        }
+        if (!ec) {
+            m_last_write = write_time;
+        }
+    }
+
+    /**
+     * @brief Frees every snapshot replaced by an earlier reload.
+     *
+     * Must only be called once no thread still uses a pointer or string view
+     * obtained before the latest reload.
+     *
+     * @return The number of snapshots freed.
+     */
+    std::size_t reclaim() {
+        std::lock_guard<std::mutex> lock(m_reload_mutex);
+        std::size_t count = m_retired.size();
+        m_retired.clear();
+        return count;
+    }
+
+private:
+    EnumString<E, N> m_schema;
+    std::filesystem::path m_path;
+
+    std::atomic<const Snapshot*> m_current{nullptr};
+    std::atomic<bool> m_reload_requested{false};
+
+    std::mutex m_reload_mutex; /**< Serializes reloaders only, never taken by lookups. */
+    std::vector<std::unique_ptr<const Snapshot>> m_retired;
+    std::filesystem::file_time_type m_last_write{};
+    uint64_t m_generation = 0;
+
+    static constexpr std::string_view trim(std::string_view str) {
+        constexpr std::string_view whitespace = " \t\r";
+        auto first = str.find_first_not_of(whitespace);
+        if (first == std::string_view::npos) {
+            return {};
+        }
+        auto last = str.find_last_not_of(whitespace);
+        return str.substr(first, last - first + 1);
+    }
+
+    [[noreturn]] void parse_error(std::size_t line_number, std::string_view reason) const {
+        std::ostringstream msg;
+        msg << m_path.string() << ':' << line_number << ": " << reason;
+        throw EnumStringException(EnumStringException::ErrorCode::ParseError, msg.str());
+    }
+
+    std::string read_file() const {
+        std::ifstream in(m_path, std::ios::binary);
+        if (!in) {
+            auto err = EnumStringException::ErrorCode::FileReadError;
+            throw EnumStringException(err, "Cannot open " + m_path.string());
+        }
+        std::ostringstream contents;
+        contents << in.rdbuf();
+        if (in.bad()) {
+            auto err = EnumStringException::ErrorCode::FileReadError;
+            throw EnumStringException(err, "Cannot read " + m_path.string());
+        }
+        return std::move(contents).str();
+    }
+
+    std::unique_ptr<Snapshot> build_snapshot(const std::string& contents) const {
+        struct Entry {
+            E enum_val;
+            std::vector<std::string_view> names; /**< Views into contents. */
+        };
+        std::vector<Entry> entries;
+        std::size_t total_size = 0;
+
+        std::string_view rest(contents);
+        for (std::size_t line_number = 1; !rest.empty(); line_number++) {
+            auto eol = rest.find('\n');
+            std::string_view line = trim(rest.substr(0, eol));
+            rest = eol == std::string_view::npos ? std::string_view{} : rest.substr(eol + 1);
+            if (line.empty() || line.front() == '#') {
+                continue;
+            }
+
+            auto eq = line.find('=');
+            if (eq == std::string_view::npos) {
+                parse_error(line_number, "expected 'canonical = name[, alias...]'");
+            }
+            std::string_view canonical = trim(line.substr(0, eq));
+            if (!m_schema.contains(canonical)) {
+                parse_error(line_number, "unknown canonical string");
+            }
+
+            Entry entry{m_schema.to_enum(canonical), {}};
+            std::string_view names = line.substr(eq + 1);
+            while (true) {
+                auto comma = names.find(',');
+                std::string_view name = trim(names.substr(0, comma));
+                if (name.empty()) {
+                    parse_error(line_number, "empty name");
+                }
+                entry.names.push_back(name);
+                total_size += name.size();
+                if (comma == std::string_view::npos) {
+                    break;
+                }
+                names = names.substr(comma + 1);
+            }
+            entries.push_back(std::move(entry));
+        }
+
+        // Copy every name into one buffer before taking views, so they never move.
+        auto snap = std::make_unique<Snapshot>();
+        snap->m_storage.reserve(total_size);
+        for (const auto& entry : entries) {
+            for (auto name : entry.names) {
+                snap->m_storage.append(name);
+            }
+        }
+
+        std::size_t offset = 0;
+        std::string_view storage(snap->m_storage);
+        m_schema.for_each_pair([&snap](E enum_val, std::string_view str_val) {
+            snap->m_lookup.emplace(str_val, enum_val);
+        });
+        for (const auto& entry : entries) {
+            bool display = true;
+            for (auto name : entry.names) {
+                std::string_view stored = storage.substr(offset, name.size());
+                offset += name.size();
+                if (display) {
+                    snap->m_display.emplace_back(entry.enum_val, stored);
+                    display = false;
+                }
+                auto [it, inserted] = snap->m_lookup.emplace(stored, entry.enum_val);
+                if (!inserted && it->second != entry.enum_val) {
+                    // A configured name takes precedence over another value's canonical string.
+                    it->second = entry.enum_val;
+                }
+            }
+        }
+
+        // Values without a line keep their canonical string; a later line overrides an earlier one.
+        std::vector<std::pair<E, std::string_view>> display;
+        display.reserve(N);
+        for (auto it = snap->m_display.rbegin(); it != snap->m_display.rend(); ++it) {
+            display.push_back(*it);
+        }
+        m_schema.for_each_pair([&display](E enum_val, std::string_view str_val) {
+            display.emplace_back(enum_val, str_val);
+        });
+        std::stable_sort(display.begin(), display.end(), Snapshot::enum_less);
+        auto last = std::unique(display.begin(), display.end(), [](const auto& a, const auto& b) {
+            return a.first == b.first;
+        });
+        display.erase(last, display.end());
+        snap->m_display = std::move(display);
+
+        return snap;
+    }
+}; // class ReloadableEnumString
+
+/**
+ * @brief Deduction guide to construct a ReloadableEnumString from its schema table.
+ */
+template<EnumType E, std::size_t N, typename I, typename Path>
+ReloadableEnumString(const EnumString<E, N, I>&, Path) -> ReloadableEnumString<E, N>;
+
+}; // namespace Topname
+
+#endif // TOPNAME_RELOADABLE_TABLE_H
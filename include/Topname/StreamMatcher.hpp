@@ -0,0 +1,278 @@
+#ifndef TOPNAME_STREAM_MATCHER_H
+#define TOPNAME_STREAM_MATCHER_H
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string_view>
+#include <type_traits>
+
+#include "Topname.hpp"
+
+namespace Topname {
+
+/**
+ * @brief What StreamMatcher::feed() knows after the bytes of a token seen so far.
+ */
+enum class StreamStatus {
+    NeedMore, /**< The bytes so far start a string of the table; finish() tells whether they already are one. */
+    Match,    /**< The bytes so far are a string of the table and no longer string starts with them. */
+    NoMatch,  /**< No string of the table starts with the bytes so far; later bytes can not change that. */
+};
+
+/**
+ * @brief The byte-level DFA of a StreamMatcher, as built at compile time.
+ *
+ * @tparam E Enum type.
+ * @tparam States The number of states, including the dead state 0.
+ * @tparam Classes The number of byte classes, including class 0 for bytes in no string.
+ */
+template<EnumType E, std::size_t States, std::size_t Classes>
+struct StreamDfa {
+    using State = std::conditional_t<States <= UINT8_MAX + 1, uint8_t,
+                  std::conditional_t<States <= UINT16_MAX + 1, uint16_t, uint32_t>>;
+
+    static constexpr State DEAD = 0;
+    static constexpr State ROOT = 1;
+
+    static constexpr uint8_t ACCEPTS = 1; /**< A string of the table ends in the state. */
+    static constexpr uint8_t LEAF = 2;    /**< The state has no transition besides to DEAD. */
+
+    std::array<uint16_t, 256> classes{};            /**< Byte class of every byte. */
+    std::array<State, States * Classes> next{};     /**< Successor of a state by byte class, row by row. */
+    std::array<E, States> values{};                 /**< The value of the string ending in a state. */
+    std::array<uint8_t, States> flags{};            /**< ACCEPTS and LEAF bits of every state. */
+}; // struct StreamDfa
+
+/**
+ * @brief The strings of a table in byte order with their values; equal strings keep declaration order.
+ */
+template<const auto& Table>
+consteval auto stream_dfa_strings() {
+    using E = std::remove_cvref_t<decltype(Table.to_enum(std::string_view{}))>;
+    constexpr std::size_t N = [] {
+        std::size_t count = 0;
+        Table.for_each_pair([&count](E, std::string_view) { count++; });
+        return count;
+    }();
+
+    struct Entry {
+        std::string_view string_val;
+        std::size_t order;
+        E enum_val;
+    };
+    std::array<Entry, N> entries{};
+    std::size_t i = 0;
+    Table.for_each_pair([&entries, &i](E enum_val, std::string_view str_val) {
+        entries[i] = {str_val, i, enum_val};
+        i++;
+    });
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return a.string_val != b.string_val ? a.string_val < b.string_val : a.order < b.order;
+    });
+    return entries;
+}
+
+/**
+ * @brief Returns the number of states of the DFA of a table: the dead state and one per distinct prefix.
+ */
+template<const auto& Table>
+consteval std::size_t stream_dfa_states() {
+    constexpr auto entries = stream_dfa_strings<Table>();
+    std::size_t states = 2;
+    std::string_view previous;
+    for (const auto& entry : entries) {
+        std::size_t common = 0;
+        while (common < previous.size() && common < entry.string_val.size() &&
+               previous[common] == entry.string_val[common]) {
+            common++;
+        }
+        states += entry.string_val.size() - common;
+        previous = entry.string_val;
+    }
+    return states;
+}
+
+/**
+ * @brief Returns the number of byte classes of the DFA of a table: one per distinct byte, plus class 0.
+ */
+template<const auto& Table>
+consteval std::size_t stream_dfa_classes() {
+    std::array<bool, 256> used{};
+    std::size_t classes = 1;
+    for (const auto& entry : stream_dfa_strings<Table>()) {
+        for (char ch : entry.string_val) {
+            auto byte = static_cast<unsigned char>(ch);
+            classes += used[byte] ? 0 : 1;
+            used[byte] = true;
+        }
+    }
+    return classes;
+}
+
+/**
+ * @brief Builds the trie of the strings of a table as a DFA with compressed byte classes.
+ */
+template<const auto& Table>
+consteval auto build_stream_dfa() {
+    constexpr auto entries = stream_dfa_strings<Table>();
+    constexpr std::size_t STATES = stream_dfa_states<Table>();
+    constexpr std::size_t CLASSES = stream_dfa_classes<Table>();
+    using E = std::remove_cvref_t<decltype(Table.to_enum(std::string_view{}))>;
+    using Dfa = StreamDfa<E, STATES, CLASSES>;
+    using State = typename Dfa::State;
+
+    Dfa dfa;
+    uint16_t next_class = 1;
+    for (const auto& entry : entries) {
+        for (char ch : entry.string_val) {
+            auto byte = static_cast<unsigned char>(ch);
+            if (dfa.classes[byte] == 0) {
+                dfa.classes[byte] = next_class++;
+            }
+        }
+    }
+
+    // Sorted strings share their common prefix with the previous one, so the states along it are reused.
+    std::array<State, Table.max_string_length() + 1> path{};
+    path[0] = Dfa::ROOT;
+    std::size_t next_state = 2;
+    std::string_view previous;
+    for (const auto& entry : entries) {
+        std::string_view str = entry.string_val;
+        std::size_t common = 0;
+        while (common < previous.size() && common < str.size() && previous[common] == str[common]) {
+            common++;
+        }
+        for (std::size_t k = common; k < str.size(); k++) {
+            auto state = static_cast<State>(next_state++);
+            dfa.next[path[k] * CLASSES + dfa.classes[static_cast<unsigned char>(str[k])]] = state;
+            path[k + 1] = state;
+        }
+        State end = path[str.size()];
+        if ((dfa.flags[end] & Dfa::ACCEPTS) == 0) {
+            dfa.flags[end] |= Dfa::ACCEPTS;
+            dfa.values[end] = entry.enum_val;
+        }
+        previous = str;
+    }
+
+    for (std::size_t state = 1; state < STATES; state++) {
+        bool leaf = true;
+        for (std::size_t c = 0; c < CLASSES; c++) {
+            leaf = leaf && dfa.next[state * CLASSES + c] == Dfa::DEAD;
+        }
+        dfa.flags[state] |= leaf ? Dfa::LEAF : 0;
+    }
+    return dfa;
+}
+
+/**
+ * @brief Matches a token against the strings of a table as its bytes arrive in chunks.
+ *
+ * Reads split tokens across buffer boundaries; instead of reassembling a
+ * token before to_enum(), each chunk is fed to the matcher as it arrives.
+ * The table is turned into a byte-level DFA at compile time: the trie of
+ * its strings, with one state per distinct prefix. Bytes are first mapped
+ * to classes, one per byte that occurs in some string and one for all
+ * others, so a state needs a transition per class rather than per byte.
+ * feed() then takes one table load per byte and returns as soon as no
+ * string can match, without reading the rest of the chunk.
+ *
+ * The matcher holds nothing but the current state, an integer of the
+ * smallest width that numbers all states, so it can be kept per stream.
+ * Sizes are computed in a first pass over the strings, so the tables are
+ * exact; they take STATES * CLASSES state integers, which suits tables of
+ * up to a few thousand short strings. The DFA matches strings exactly and
+ * lookups are not reported to the instrumentation policy.
+ *
+ * @code
+ * constexpr auto method_names = EnumString(Method::Get, "GET", Method::Post, "POST");
+ * StreamMatcher<method_names> method;
+ * method.feed(std::span<const char>("PO", 2)); // StreamStatus::NeedMore
+ * method.feed(std::span<const char>("ST", 2)); // StreamStatus::Match
+ * method.finish();                             // Method::Post
+ * @endcode
+ *
+ * @tparam Table An EnumString with static storage duration.
+ */
+template<const auto& Table>
+class StreamMatcher {
+    static constexpr auto DFA = build_stream_dfa<Table>();
+    using Dfa = std::remove_cvref_t<decltype(DFA)>;
+
+public:
+    using Enum = std::remove_cvref_t<decltype(Table.to_enum(std::string_view{}))>;
+    using State = typename Dfa::State;
+
+    /** @brief The number of states, including the dead state. */
+    static constexpr std::size_t STATES = DFA.flags.size();
+    /** @brief The number of byte classes, including the class of bytes in no string. */
+    static constexpr std::size_t CLASSES = DFA.next.size() / STATES;
+
+    /**
+     * @brief Starts a matcher before the first byte of a token.
+     */
+    constexpr StreamMatcher() noexcept = default;
+
+    /**
+     * @brief Advances the matcher over the next bytes of the token.
+     *
+     * @param bytes The next chunk of the token; it may be empty.
+     * @return Whether the bytes seen so far match, can not match, or may still match.
+     */
+    constexpr StreamStatus feed(std::span<const char> bytes) noexcept {
+        State state = m_state;
+        for (char ch : bytes) {
+            if (state == Dfa::DEAD) {
+                break;
+            }
+            state = DFA.next[state * CLASSES + DFA.classes[static_cast<unsigned char>(ch)]];
+        }
+        m_state = state;
+        return status();
+    }
+
+    /**
+     * @brief Returns what is known after the bytes fed so far, as feed() last returned.
+     */
+    [[nodiscard]] constexpr StreamStatus status() const noexcept {
+        if (m_state == Dfa::DEAD) {
+            return StreamStatus::NoMatch;
+        }
+        return (DFA.flags[m_state] & Dfa::LEAF) != 0 ? StreamStatus::Match : StreamStatus::NeedMore;
+    }
+
+    /**
+     * @brief Ends the token.
+     *
+     * @return The value of the string the bytes fed so far spell, or std::nullopt if they spell none.
+     */
+    [[nodiscard]] constexpr std::optional<Enum> finish() const noexcept {
+        if ((DFA.flags[m_state] & Dfa::ACCEPTS) == 0) {
+            return std::nullopt;
+        }
+        return DFA.values[m_state];
+    }
+
+    /**
+     * @brief Starts over for the next token.
+     */
+    constexpr void reset() noexcept { m_state = Dfa::ROOT; }
+
+    /**
+     * @brief Returns the bytes of the transition and class tables shared by all matchers of this table.
+     */
+    [[nodiscard]] static constexpr std::size_t table_bytes() noexcept {
+        return sizeof(DFA.classes) + sizeof(DFA.next);
+    }
+
+private:
+    State m_state = Dfa::ROOT;
+}; // class StreamMatcher
+
+}; // namespace Topname
+
+#endif // TOPNAME_STREAM_MATCHER_H
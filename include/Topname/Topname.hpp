@@ -3,14 +3,22 @@
 
 #include <algorithm> // std::ranges::find_if, std::ranges::for_each
 #include <array>
+#include <bit>
+#include <cstdint>
 #include <functional> // std::invoke
 #include <iterator> // for std::random_access_iterator_tag
+#include <limits>
+#include <optional>
 #include <ostream>
 #include <stdexcept>
 #include <string_view>
 #include <type_traits>
 #include <vector>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace Topname {
 /**
  * @brief Exception class for EnumString-related errors.
@@ -25,6 +33,9 @@ public:
         InvalidEnumValue,
         InvalidStringValue,
         OutOfRange,
+        FileReadError,
+        ParseError,
+        EngineUnavailable,
         // Add more error codes as needed
     };
     
@@ -57,6 +68,20 @@ constexpr auto enum_to_underlying(E enum_value) noexcept {
     return static_cast<std::underlying_type_t<E>>(enum_value);
 }
 
+/**
+ * @brief Returns how far an enum value lies above a base value, computed without signed overflow.
+ *
+ * @tparam E Enum type.
+ * @param enum_value The enum value, not below base.
+ * @param base The underlying value of the smallest enum value of a range.
+ * @return enum_value - base, e.g. an index into a table of the range.
+ */
+template<EnumType E>
+constexpr uint64_t enum_offset(E enum_value, std::underlying_type_t<E> base) noexcept {
+    using Unsigned = std::make_unsigned_t<std::underlying_type_t<E>>;
+    return static_cast<Unsigned>(static_cast<Unsigned>(enum_to_underlying(enum_value)) - static_cast<Unsigned>(base));
+}
+
 /**
  * @brief Computes a hash value for a string using the djb2 algorithm.
  * 
@@ -71,6 +96,24 @@ constexpr uint32_t hash(std::string_view str) {
     return hash;
 }
 
+/**
+ * @brief Finalizes a djb2 hash so that its low bits are usable as a table index.
+ *
+ * djb2 concentrates entropy in the high bits for short keys; the murmur3
+ * finalizer spreads it before the hash is reduced to a table size.
+ *
+ * @param h The hash to mix.
+ * @return The mixed hash value.
+ */
+constexpr uint32_t mix_hash(uint32_t h) noexcept {
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h;
+}
+
 /**
  * @brief Compares two strings for equality in a case-insensitive manner.
  * 
@@ -85,6 +128,336 @@ constexpr bool case_insensitive_equal(std::string_view a, std::string_view b) {
     });
 }
 
+/**
+ * @brief How a quoted token escapes the characters it contains.
+ */
+enum class QuoteStyle {
+    Json, /**< Backslash escapes as in RFC 8259, including \\uXXXX and surrogate pairs. */
+    Csv,  /**< A quote inside the token is doubled, as in RFC 4180. */
+};
+
+/**
+ * @brief Returns the first byte of a token body that ends or escapes it, or end.
+ *
+ * That is the first '"', and for QuoteStyle::Json also the first '\\'. With
+ * SSE2, 16 bytes are checked per step while a whole block is in range.
+ */
+constexpr const char* find_quote_special(const char* p, const char* end, QuoteStyle style) noexcept {
+    const char escape = style == QuoteStyle::Json ? '\\' : '"';
+#if defined(__SSE2__)
+    if (!std::is_constant_evaluated()) {
+        const __m128i quotes = _mm_set1_epi8('"');
+        const __m128i escapes = _mm_set1_epi8(escape);
+        for (; end - p >= 16; p += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_or_si128(_mm_cmpeq_epi8(block, quotes), _mm_cmpeq_epi8(block, escapes))));
+            if (mask != 0) {
+                return p + std::countr_zero(mask);
+            }
+        }
+    }
+#endif
+    while (p != end && *p != '"' && *p != escape) {
+        p++;
+    }
+    return p;
+}
+
+/**
+ * @brief Decodes the rest of a quoted token, from anywhere after the opening quote outside an escape.
+ *
+ * @return One past the closing quote, or nullptr if the token is not closed or has an invalid escape.
+ */
+template<typename Sink>
+constexpr const char* unescape_quoted_body(const char* p, const char* end, QuoteStyle style, Sink&& sink) {
+    auto hex4 = [&p, end]() -> std::optional<uint32_t> {
+        if (end - p < 4) {
+            return std::nullopt;
+        }
+        uint32_t value = 0;
+        for (int i = 0; i < 4; i++, p++) {
+            char c = *p;
+            uint32_t digit = c >= '0' && c <= '9' ? static_cast<uint32_t>(c - '0')
+                           : c >= 'a' && c <= 'f' ? static_cast<uint32_t>(c - 'a' + 10)
+                           : c >= 'A' && c <= 'F' ? static_cast<uint32_t>(c - 'A' + 10)
+                           : 16;
+            if (digit == 16) {
+                return std::nullopt;
+            }
+            value = value << 4 | digit;
+        }
+        return value;
+    };
+    auto run = [](const char* from, const char* to) {
+        return std::string_view(from, static_cast<std::size_t>(to - from));
+    };
+
+    while (true) {
+        const char* special = find_quote_special(p, end, style);
+        if (special == end) {
+            return nullptr;
+        }
+        if (style == QuoteStyle::Csv) {
+            if (end - special < 2 || special[1] != '"') {
+                sink(run(p, special));
+                return special + 1;
+            }
+            sink(run(p, special + 1)); // The run and one quote of the pair.
+            p = special + 2;
+            continue;
+        }
+        sink(run(p, special));
+        if (*special == '"') {
+            return special + 1;
+        }
+        if (end - special < 2) {
+            return nullptr;
+        }
+        char escaped = special[1];
+        p = special + 2;
+        char decoded[4] = {};
+        switch (escaped) {
+            case '"': case '\\': case '/': decoded[0] = escaped; break;
+            case 'b': decoded[0] = '\b'; break;
+            case 'f': decoded[0] = '\f'; break;
+            case 'n': decoded[0] = '\n'; break;
+            case 'r': decoded[0] = '\r'; break;
+            case 't': decoded[0] = '\t'; break;
+            case 'u': break;
+            default: return nullptr;
+        }
+        if (escaped != 'u') {
+            sink(std::string_view(decoded, 1));
+            continue;
+        }
+        std::optional<uint32_t> unit = hex4();
+        if (!unit || (*unit >= 0xdc00 && *unit <= 0xdfff)) {
+            return nullptr;
+        }
+        uint32_t code = *unit;
+        if (code >= 0xd800 && code <= 0xdbff) {
+            if (end - p < 2 || p[0] != '\\' || p[1] != 'u') {
+                return nullptr;
+            }
+            p += 2;
+            std::optional<uint32_t> low = hex4();
+            if (!low || *low < 0xdc00 || *low > 0xdfff) {
+                return nullptr;
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (*low - 0xdc00);
+        }
+        std::size_t size = 0;
+        if (code < 0x80) {
+            decoded[size++] = static_cast<char>(code);
+        } else if (code < 0x800) {
+            decoded[size++] = static_cast<char>(0xc0 | code >> 6);
+            decoded[size++] = static_cast<char>(0x80 | (code & 0x3f));
+        } else if (code < 0x10000) {
+            decoded[size++] = static_cast<char>(0xe0 | code >> 12);
+            decoded[size++] = static_cast<char>(0x80 | (code >> 6 & 0x3f));
+            decoded[size++] = static_cast<char>(0x80 | (code & 0x3f));
+        } else {
+            decoded[size++] = static_cast<char>(0xf0 | code >> 18);
+            decoded[size++] = static_cast<char>(0x80 | (code >> 12 & 0x3f));
+            decoded[size++] = static_cast<char>(0x80 | (code >> 6 & 0x3f));
+            decoded[size++] = static_cast<char>(0x80 | (code & 0x3f));
+        }
+        sink(std::string_view(decoded, size));
+    }
+}
+
+/**
+ * @brief Decodes a quoted token and passes its unescaped bytes to a sink.
+ *
+ * The sink receives the bytes in order as string_views: runs of the input
+ * between escapes, which may be empty, and the bytes each escape stands
+ * for. Nothing is copied, so the token can be hashed or compared while it
+ * is decoded. JSON \\u escapes are passed on as UTF-8.
+ *
+ * @param p The opening quote.
+ * @param end The end of the input; the token may be followed by more input.
+ * @param style How the token escapes quotes.
+ * @param sink Called with consecutive pieces of the unescaped token.
+ * @return One past the closing quote, or nullptr if the token is not closed or has an invalid escape.
+ */
+template<typename Sink>
+constexpr const char* unescape_quoted(const char* p, const char* end, QuoteStyle style, Sink&& sink) {
+    if (p == end || *p != '"') {
+        return nullptr;
+    }
+    return unescape_quoted_body(p + 1, end, style, sink);
+}
+
+/**
+ * @brief The EnumString operations reported to an instrumentation policy.
+ */
+enum class LookupOp {
+    ToEnum,
+    ToEnumInsensitive,
+    ToString,
+    ContainsEnum,
+    ContainsString,
+};
+
+/**
+ * @brief The default instrumentation policy of EnumString, which records nothing.
+ *
+ * A policy provides a Scope type that every lookup constructs with its
+ * LookupOp, calls hit() on when it finds a mapping, calls miss() with the
+ * input when a string lookup fails, and destroys when it returns or throws.
+ * Scope must be usable in constant expressions; see Instrumentation.hpp for
+ * recording policies.
+ */
+struct NoInstrumentation {
+    struct Scope {
+        constexpr explicit Scope(LookupOp) noexcept {}
+        constexpr void hit() noexcept {}
+        constexpr void miss(std::string_view) noexcept {}
+    };
+};
+
+/**
+ * @brief The strategies EnumString can use to convert strings to enum values.
+ */
+enum class Engine {
+    Auto,        /**< Chosen by the cost model when the table is built. */
+    LinearScan,  /**< Compares the input with every string, in declaration order or by EntryWeights. */
+    HashProbe,   /**< djb2 hash table with linear probing. */
+    PerfectHash, /**< Collision-free hash-and-displace table, always a single probe. */
+};
+
+/**
+ * @brief Returns a human-readable name of an engine.
+ */
+constexpr std::string_view engine_name(Engine engine) noexcept {
+    switch (engine) {
+        case Engine::Auto: return "auto";
+        case Engine::LinearScan: return "linear scan";
+        case Engine::HashProbe: return "djb2 + linear probing";
+        case Engine::PerfectHash: return "djb2 + perfect hash";
+    }
+    return "?";
+}
+
+/**
+ * @brief Per-lookup costs, in nanoseconds, from which Engine::Auto picks an engine.
+ *
+ * The defaults are the medians of nine fits by benchmarks/engine_bench.cpp
+ * on an x86-64 machine with GCC -O2. To calibrate for another target, run
+ * it there and build with the -DTOPNAME_ENGINE_COST_MODEL='{...}' flag it
+ * prints, which replaces DEFAULT_ENGINE_COST_MODEL with the fitted model.
+ */
+struct EngineCostModel {
+    double scan_fixed;    /**< LinearScan: fixed cost of a lookup. */
+    double scan_entry;    /**< LinearScan: per entry passed over. */
+    double compare_byte;  /**< LinearScan: per byte compared against an entry of equal length. */
+    double hash_byte;     /**< Hash engines: per input byte hashed. */
+    double hash_fixed;    /**< HashProbe: fixed cost of a lookup. */
+    double probe;         /**< HashProbe: per slot inspected. */
+    double perfect_fixed; /**< PerfectHash: fixed cost of a lookup, including the displacement load. */
+};
+
+#if defined(TOPNAME_ENGINE_COST_MODEL)
+inline constexpr EngineCostModel DEFAULT_ENGINE_COST_MODEL TOPNAME_ENGINE_COST_MODEL;
+#else
+inline constexpr EngineCostModel DEFAULT_ENGINE_COST_MODEL{
+    .scan_fixed = 12.9,
+    .scan_entry = 1.29,
+    .compare_byte = 0.0,
+    .hash_byte = 1.01,
+    .hash_fixed = 0.0,
+    .probe = 9.64,
+    .perfect_fixed = 13.5,
+};
+#endif
+
+/**
+ * @brief Predicted to_enum() cost of each engine for one table, in the units of the model.
+ *
+ * An engine that can not serve the table correctly costs infinity.
+ */
+struct EngineCosts {
+    double linear_scan = 0.0;
+    double hash_probe = 0.0;
+    double perfect_hash = 0.0;
+
+    /**
+     * @brief Returns the cheapest engine, preferring the simpler one on ties.
+     */
+    [[nodiscard]] constexpr Engine cheapest() const noexcept {
+        if (linear_scan <= hash_probe && linear_scan <= perfect_hash) {
+            return Engine::LinearScan;
+        }
+        return hash_probe <= perfect_hash ? Engine::HashProbe : Engine::PerfectHash;
+    }
+};
+
+/**
+ * @brief Quality figures for the lookup table of an EnumString.
+ *
+ * Probe lengths count the slots (for Engine::LinearScan, the entries, in
+ * scan order) inspected by to_enum() to reach an entry, so an entry in its
+ * home slot has a probe length of 1.
+ */
+struct HashTableStats {
+    std::size_t size = 0;                 /**< Number of mappings. */
+    std::size_t capacity = 0;             /**< Number of hash table slots, 0 for Engine::LinearScan. */
+    std::size_t max_probe_length = 0;
+    double average_probe_length = 0.0;
+    std::size_t clusters = 0;             /**< Runs of consecutive occupied slots. */
+    std::size_t largest_cluster = 0;
+    std::size_t displaced_entries = 0;    /**< Entries not stored in their home slot. */
+    std::size_t hash_collisions = 0;      /**< Distinct strings sharing a 32-bit hash with an earlier one. */
+    std::size_t unreachable_entries = 0;  /**< Entries to_enum() resolves to a different enum value. */
+    std::string_view engine;              /**< Name of the active lookup strategy, see engine_name(). */
+};
+
+/**
+ * @brief Relative lookup frequencies of the mappings of an EnumString, in declaration order.
+ *
+ * Passed as the first constructor argument, they make the scans of to_string(),
+ * to_enum_insensitive(), contains() and Engine::LinearScan visit heavy entries
+ * first, and the hash table insert them first so that they sit in their home
+ * slots. Iteration order is unaffected. tools/trace_weights.cpp derives them
+ * from a recorded trace of looked up strings.
+ *
+ * @code
+ * constexpr auto colors = EnumString(EntryWeights(1, 900, 40), Color::Red, "Red", Color::Green, "Green", ...);
+ * @endcode
+ *
+ * @tparam N The number of mappings.
+ */
+template<std::size_t N>
+struct EntryWeights {
+    std::array<uint64_t, N> weights{};
+
+    constexpr EntryWeights() = default;
+
+    constexpr explicit EntryWeights(const std::array<uint64_t, N>& w) : weights(w) {}
+
+    template<typename... W>
+        requires (sizeof...(W) == N && (std::is_integral_v<W> && ...))
+    constexpr explicit EntryWeights(W... w) : weights{static_cast<uint64_t>(w)...} {}
+};
+
+/**
+ * @brief Deduction guide to construct EntryWeights from a list of weights.
+ */
+template<typename... W>
+EntryWeights(W...) -> EntryWeights<sizeof...(W)>;
+
+/**
+ * @brief The result of EnumString::to_enum_from_quoted().
+ *
+ * @tparam E Enum type.
+ */
+template<EnumType E>
+struct QuotedMatch {
+    E value;              /**< The enum value of the unescaped token. */
+    std::size_t consumed; /**< Bytes from the opening quote through the closing quote. */
+};
+
 /**
  * @brief A class that maps enum values to corresponding strings and vice versa.
  * 
@@ -92,8 +465,9 @@ constexpr bool case_insensitive_equal(std::string_view a, std::string_view b) {
  * 
  * @tparam E Enum type.
  * @tparam N The number of mappings.
+ * @tparam Instrumentation Policy notified of every lookup, NoInstrumentation by default.
  */
-template<EnumType E, std::size_t N>
+template<EnumType E, std::size_t N, typename Instrumentation = NoInstrumentation>
 class EnumString {
 private:
     /**
@@ -106,22 +480,425 @@ private:
 
     std::array<EnumStringPair, N> mappings; /**< The array of enum-string pairs. */
 
+    static constexpr uint32_t EMPTY_SLOT = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief A hash table slot: the djb2 hash of a string and the index of its mapping.
+     */
+    struct HashSlot {
+        uint32_t full = 0;
+        uint32_t index = EMPTY_SLOT;
+    };
+
     static constexpr std::size_t HASH_TABLE_SIZE = N * 2;
-    std::array<std::pair<uint32_t, E>, HASH_TABLE_SIZE> hash_table{};
+    std::array<HashSlot, HASH_TABLE_SIZE> hash_table{};
+
+    static constexpr std::size_t PERFECT_HASH_BUCKETS = N / 2 + 1;
+    static constexpr uint32_t PERFECT_HASH_MAX_TRIES = 1u << 16; /**< Displacements tried per bucket. */
+    std::array<uint32_t, PERFECT_HASH_BUCKETS> displacements{}; /**< Used by Engine::PerfectHash only. */
+
+    Engine selected_engine = Engine::HashProbe;
+
+    std::array<uint32_t, N> scan_order = identity_order(); /**< Mapping indices, heaviest first. */
+    bool weighted = false;                                  /**< False while scan_order is the identity. */
+    std::size_t max_length = 0;                             /**< Length of the longest string. */
+
+    static constexpr std::array<uint32_t, N> identity_order() {
+        std::array<uint32_t, N> order{};
+        for (std::size_t i = 0; i < N; i++) {
+            order[i] = static_cast<uint32_t>(i);
+        }
+        return order;
+    }
+
+    /**
+     * @brief Sorts scan_order by descending weight.
+     *
+     * Lookups return the first declared of several matching entries: to_string()
+     * the first string of an enum value, to_enum() and to_enum_insensitive()
+     * the first enum value of a string. An entry is therefore given at least
+     * the weight of every later entry that shares its enum value or its
+     * (ASCII case-folded) string, and ties keep declaration order, so it is
+     * always scanned before them.
+     */
+    constexpr void order_by_weight(const EntryWeights<N>& entry_weights) {
+        auto lower = [](char c) {
+            return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+        };
+        auto string_less = [&](uint32_t a, uint32_t b) {
+            std::string_view x = mappings[a].string_val, y = mappings[b].string_val;
+            for (std::size_t i = 0; i < x.size() && i < y.size(); i++) {
+                if (lower(x[i]) != lower(y[i])) {
+                    return lower(x[i]) < lower(y[i]);
+                }
+            }
+            return x.size() != y.size() ? x.size() < y.size() : a < b;
+        };
+        auto string_same = [&](uint32_t a, uint32_t b) {
+            return std::ranges::equal(mappings[a].string_val, mappings[b].string_val,
+                                      [&](char c1, char c2) { return lower(c1) == lower(c2); });
+        };
+        auto enum_less = [&](uint32_t a, uint32_t b) {
+            auto x = enum_to_underlying(mappings[a].enum_val), y = enum_to_underlying(mappings[b].enum_val);
+            return x != y ? x < y : a < b;
+        };
+
+        // next_*[i]: the next entry in declaration order sharing i's enum value or string, N if none.
+        std::array<uint32_t, N> by_enum = identity_order(), by_string = identity_order();
+        std::sort(by_enum.begin(), by_enum.end(), enum_less);
+        std::sort(by_string.begin(), by_string.end(), string_less);
+        std::array<uint32_t, N> next_enum{}, next_string{};
+        next_enum.fill(static_cast<uint32_t>(N));
+        next_string.fill(static_cast<uint32_t>(N));
+        for (std::size_t k = 0; k + 1 < N; k++) {
+            if (mappings[by_enum[k]].enum_val == mappings[by_enum[k + 1]].enum_val) {
+                next_enum[by_enum[k]] = by_enum[k + 1];
+            }
+            if (string_same(by_string[k], by_string[k + 1])) {
+                next_string[by_string[k]] = by_string[k + 1];
+            }
+        }
+
+        std::array<uint64_t, N> effective = entry_weights.weights;
+        for (std::size_t i = N; i-- > 0;) {
+            if (next_enum[i] != N) {
+                effective[i] = std::max(effective[i], effective[next_enum[i]]);
+            }
+            if (next_string[i] != N) {
+                effective[i] = std::max(effective[i], effective[next_string[i]]);
+            }
+        }
+        scan_order = identity_order();
+        std::sort(scan_order.begin(), scan_order.end(), [&effective](uint32_t a, uint32_t b) {
+            return effective[a] != effective[b] ? effective[a] > effective[b] : a < b;
+        });
+        weighted = true;
+    }
+
+    /**
+     * @brief Returns the weights that reproduce scan_order, or std::nullopt if it is the identity.
+     */
+    constexpr std::optional<EntryWeights<N>> scan_weights() const {
+        if (!weighted) {
+            return std::nullopt;
+        }
+        EntryWeights<N> w;
+        for (std::size_t k = 0; k < N; k++) {
+            w.weights[scan_order[k]] = N - k;
+        }
+        return w;
+    }
+
+    /**
+     * @brief Returns the index of the first mapping in scan order that satisfies pred, or N.
+     */
+    template<typename Pred>
+    constexpr std::size_t scan_find(Pred pred) const {
+        if (!weighted) {
+            for (std::size_t i = 0; i < N; i++) {
+                if (pred(mappings[i])) {
+                    return i;
+                }
+            }
+            return N;
+        }
+        for (uint32_t i : scan_order) {
+            if (pred(mappings[i])) {
+                return i;
+            }
+        }
+        return N;
+    }
 
     /**
      * @brief Builds the hash table for quicker lookups.
+     *
+     * Later duplicates of a string are left out, since lookups stop at its
+     * first occurrence. Distinct strings sharing a hash both get a slot.
      */
     constexpr void build_hash_table() {
-        for (const auto& pair : mappings) {
-            uint32_t h = hash(pair.string_val) % HASH_TABLE_SIZE;
-            while (hash_table[h].first != 0) {
+        for (uint32_t i : scan_order) {
+            uint32_t full = hash(mappings[i].string_val);
+            uint32_t h = full % HASH_TABLE_SIZE;
+            bool duplicate = false;
+            while (hash_table[h].index != EMPTY_SLOT && !duplicate) {
+                duplicate = hash_table[h].full == full &&
+                            mappings[hash_table[h].index].string_val == mappings[i].string_val;
                 h = (h + 1) % HASH_TABLE_SIZE;
             }
-            hash_table[h] = {hash(pair.string_val), pair.enum_val};
+            if (!duplicate) {
+                hash_table[h] = {full, i};
+            }
         }
     }
 
+    static constexpr std::size_t perfect_hash_bucket(uint32_t full) noexcept {
+        return mix_hash(full) % PERFECT_HASH_BUCKETS;
+    }
+
+    static constexpr std::size_t perfect_hash_slot(uint32_t full, uint32_t displacement) noexcept {
+        return mix_hash(full ^ (displacement * 0x9e3779b9u)) % HASH_TABLE_SIZE;
+    }
+
+    /**
+     * @brief Places every string in a slot of its own (hash and displace).
+     *
+     * Strings are grouped into buckets by one hash; buckets are then placed
+     * largest first, each searching for a displacement that sends all of its
+     * strings to free slots. Duplicate strings keep their first occurrence,
+     * like build_hash_table().
+     *
+     * @return False if two distinct strings share a hash or a bucket runs out of displacements.
+     */
+    constexpr bool build_perfect_hash() {
+        std::array<uint32_t, N> hashes{};
+        std::array<uint32_t, N> order{};
+        std::array<uint32_t, PERFECT_HASH_BUCKETS + 1> starts{};
+        std::array<uint32_t, PERFECT_HASH_BUCKETS> sizes{};
+        for (std::size_t i = 0; i < N; i++) {
+            hashes[i] = hash(mappings[i].string_val);
+            starts[perfect_hash_bucket(hashes[i]) + 1]++;
+        }
+        for (std::size_t b = 0; b < PERFECT_HASH_BUCKETS; b++) {
+            starts[b + 1] += starts[b];
+        }
+        for (std::size_t i = 0; i < N; i++) {
+            std::size_t b = perfect_hash_bucket(hashes[i]);
+            order[starts[b] + sizes[b]++] = static_cast<uint32_t>(i);
+        }
+
+        // Drop later duplicates of a string from their bucket; equal hashes always share a bucket.
+        std::size_t largest = 0;
+        for (std::size_t b = 0; b < PERFECT_HASH_BUCKETS; b++) {
+            std::size_t unique = 0;
+            for (std::size_t k = starts[b]; k < starts[b + 1]; k++) {
+                bool duplicate = false;
+                for (std::size_t j = starts[b]; j < starts[b] + unique; j++) {
+                    if (hashes[order[j]] == hashes[order[k]]) {
+                        if (mappings[order[j]].string_val != mappings[order[k]].string_val) {
+                            return false;
+                        }
+                        duplicate = true;
+                        break;
+                    }
+                }
+                if (!duplicate) {
+                    order[starts[b] + unique++] = order[k];
+                }
+            }
+            sizes[b] = static_cast<uint32_t>(unique);
+            largest = std::max(largest, unique);
+        }
+
+        for (std::size_t size = largest; size > 0; size--) {
+            for (std::size_t b = 0; b < PERFECT_HASH_BUCKETS; b++) {
+                if (sizes[b] == size && !place_perfect_hash_bucket(b, hashes, order, starts[b], size)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    constexpr bool place_perfect_hash_bucket(std::size_t bucket, const std::array<uint32_t, N>& hashes,
+                                             const std::array<uint32_t, N>& order,
+                                             std::size_t first, std::size_t size) {
+        for (uint32_t displacement = 1; displacement <= PERFECT_HASH_MAX_TRIES; displacement++) {
+            std::size_t placed = 0;
+            while (placed < size) {
+                uint32_t full = hashes[order[first + placed]];
+                std::size_t slot = perfect_hash_slot(full, displacement);
+                if (hash_table[slot].index != EMPTY_SLOT) {
+                    break;
+                }
+                hash_table[slot] = {full, order[first + placed]};
+                placed++;
+            }
+            if (placed == size) {
+                displacements[bucket] = displacement;
+                return true;
+            }
+            while (placed-- > 0) {
+                hash_table[perfect_hash_slot(hashes[order[first + placed]], displacement)] = {};
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Resolves the engine and builds its index, after noting the longest string.
+     *
+     * @throw EngineUnavailable If PerfectHash was requested and can not be built.
+     */
+    constexpr void build_engine(Engine requested) {
+        for (const auto& pair : mappings) {
+            max_length = std::max(max_length, pair.string_val.size());
+        }
+        Engine chosen = requested == Engine::Auto ? engine_costs().cheapest() : requested;
+        if (chosen == Engine::PerfectHash) {
+            if (build_perfect_hash()) {
+                selected_engine = Engine::PerfectHash;
+                return;
+            }
+            hash_table = {};
+            displacements = {};
+            if (requested == Engine::PerfectHash) {
+                auto err = EnumStringException::ErrorCode::EngineUnavailable;
+                throw EnumStringException(err, "No perfect hash exists for these strings");
+            }
+            EngineCosts costs = engine_costs();
+            costs.perfect_hash = std::numeric_limits<double>::infinity();
+            chosen = costs.cheapest();
+        }
+        selected_engine = chosen;
+        if (chosen == Engine::HashProbe) {
+            build_hash_table();
+        }
+    }
+
+    /**
+     * @brief Looks a string up with the active engine.
+     *
+     * @return The enum value of the string, or std::nullopt if it is not mapped.
+     */
+    constexpr std::optional<E> find_enum(std::string_view value) const noexcept {
+        if (selected_engine == Engine::LinearScan) {
+            std::size_t i = scan_find([value](const auto& pair) { return pair.string_val == value; });
+            if (i == N) {
+                return std::nullopt;
+            }
+            return mappings[i].enum_val;
+        }
+
+        return find_hashed(hash(value), [value](std::string_view candidate) { return candidate == value; });
+    }
+
+    /**
+     * @brief Looks a string up with a hash engine, given its djb2 hash.
+     *
+     * A slot matches only if its hash is equal and equal() accepts its
+     * string, so strings that merely share a hash with a mapped one miss.
+     *
+     * @param full The djb2 hash of the string.
+     * @param equal Tells whether a mapped string of the same hash is the string looked up.
+     */
+    template<typename Equal>
+    constexpr std::optional<E> find_hashed(uint32_t full, Equal&& equal) const {
+        if (selected_engine == Engine::PerfectHash) {
+            const HashSlot& slot = hash_table[perfect_hash_slot(full, displacements[perfect_hash_bucket(full)])];
+            if (slot.full == full && slot.index != EMPTY_SLOT && equal(mappings[slot.index].string_val)) {
+                return mappings[slot.index].enum_val;
+            }
+            return std::nullopt;
+        }
+
+        for (uint32_t h = full % HASH_TABLE_SIZE; hash_table[h].index != EMPTY_SLOT; h = (h + 1) % HASH_TABLE_SIZE) {
+            const HashSlot& slot = hash_table[h];
+            if (slot.full == full && equal(mappings[slot.index].string_val)) {
+                return mappings[slot.index].enum_val;
+            }
+        }
+        return std::nullopt;
+    }
+
+    static constexpr std::size_t QUOTED_BUFFER = 64; /**< Unescaped bytes of a token kept on the stack. */
+
+    /**
+     * @brief Looks a quoted token up, unescaping it only if it contains escapes.
+     *
+     * @param after Set to one past the closing quote, or nullptr if the token is malformed.
+     * @param buffer Receives the first QUOTED_BUFFER unescaped bytes of an escaped token.
+     * @param token Set to the unescaped token, truncated to QUOTED_BUFFER bytes if it is escaped and longer.
+     */
+    constexpr std::optional<E> find_quoted(const char* p, const char* end, QuoteStyle style, const char*& after,
+                                           std::array<char, QUOTED_BUFFER>& buffer, std::string_view& token) const {
+        if (p == end || *p != '"') {
+            after = nullptr;
+            return std::nullopt;
+        }
+        const char* special = find_quote_special(p + 1, end, style);
+        bool doubled = style == QuoteStyle::Csv && end - special >= 2 && special[1] == '"';
+        if (special != end && *special == '"' && !doubled) {
+            after = special + 1;
+            token = std::string_view(p + 1, static_cast<std::size_t>(special - p - 1));
+            return find_enum(token);
+        }
+        if (special == end) {
+            after = nullptr;
+            return std::nullopt;
+        }
+
+        // Escaped: decode once into the buffer and, for the hash engines, the djb2 hash, resuming after the
+        // escape-free prefix.
+        const bool hashed = selected_engine != Engine::LinearScan;
+        uint32_t full = 5381;
+        std::size_t length = 0;
+        auto sink = [hashed, &full, &length, &buffer](std::string_view piece) {
+            for (char ch : hashed ? piece : std::string_view()) {
+                full = ((full << 5) + full) + ch;
+            }
+            if (length < QUOTED_BUFFER) {
+                std::size_t kept = std::min(piece.size(), QUOTED_BUFFER - length);
+                std::copy(piece.begin(), piece.begin() + kept, buffer.begin() + length);
+            }
+            length += piece.size();
+        };
+        sink(std::string_view(p + 1, static_cast<std::size_t>(special - p - 1)));
+        after = unescape_quoted_body(special, end, style, sink);
+        token = std::string_view(buffer.data(), std::min(length, QUOTED_BUFFER));
+        if (after == nullptr || length > max_length) {
+            return std::nullopt;
+        }
+
+        // Candidates are compared with the buffer, or decoded again alongside it if the token did not fit.
+        auto same = [=](std::string_view candidate) {
+            if (candidate.size() != length) {
+                return false;
+            }
+            if (length <= QUOTED_BUFFER) {
+                return candidate == token;
+            }
+            std::size_t k = 0;
+            bool equal = true;
+            unescape_quoted(p, end, style, [&](std::string_view piece) {
+                equal = equal && candidate.substr(k, piece.size()) == piece;
+                k += piece.size();
+            });
+            return equal;
+        };
+        if (hashed) {
+            return find_hashed(full, same);
+        }
+        std::size_t i = scan_find([&same](const auto& pair) { return same(pair.string_val); });
+        if (i == N) {
+            return std::nullopt;
+        }
+        return mappings[i].enum_val;
+    }
+
+    struct FromPairsTag {};
+
+    constexpr EnumString(FromPairsTag, const std::array<std::pair<E, std::string_view>, N>& pairs, Engine engine,
+                         const std::optional<EntryWeights<N>>& entry_weights = std::nullopt)
+    : mappings{}
+    {
+        for (std::size_t i = 0; i < N; i++) {
+            mappings[i] = {pairs[i].first, pairs[i].second};
+        }
+        if (entry_weights) {
+            order_by_weight(*entry_weights);
+        }
+        build_engine(engine);
+    }
+
+    constexpr std::array<std::pair<E, std::string_view>, N> to_pairs() const {
+        std::array<std::pair<E, std::string_view>, N> pairs{};
+        for (std::size_t i = 0; i < N; i++) {
+            pairs[i] = {mappings[i].enum_val, mappings[i].string_val};
+        }
+        return pairs;
+    }
+
 public:
     /**
      * @brief Constructs an EnumString with a list of enum-string pairs.
@@ -130,33 +907,272 @@ public:
      * @param args The mappings in pairs of enum values and their corresponding strings.
      */
     template<typename... Args>
+        requires (!(std::is_same_v<std::remove_cvref_t<Args>, FromPairsTag> || ...)
+                  && !(std::is_same_v<std::remove_cvref_t<Args>, EntryWeights<N>> || ...))
     constexpr EnumString(Args&&... args)
     : mappings{{std::forward<Args>(args)...}}
     {
-        build_hash_table();
+        build_engine(Engine::Auto);
+    }
+
+    /**
+     * @brief Constructs an EnumString whose lookups visit the heaviest mappings first.
+     * 
+     * @tparam Args Variadic template arguments for the mappings.
+     * @param entry_weights The relative lookup frequency of each mapping, in declaration order.
+     * @param args The mappings in pairs of enum values and their corresponding strings.
+     */
+    template<typename... Args>
+    constexpr EnumString(EntryWeights<N> entry_weights, Args&&... args)
+    : mappings{{std::forward<Args>(args)...}}
+    {
+        order_by_weight(entry_weights);
+        build_engine(Engine::Auto);
+    }
+
+    /**
+     * @brief Constructs an EnumString from an array of enum-string pairs.
+     * 
+     * Useful when the mappings are generated rather than spelled out, e.g. with
+     * large N where a variadic argument list is impractical.
+     * 
+     * @param pairs The enum values and their corresponding strings.
+     * @return The EnumString holding the given mappings.
+     */
+    [[nodiscard]] static constexpr EnumString from_pairs(
+        const std::array<std::pair<E, std::string_view>, N>& pairs) {
+        return EnumString(FromPairsTag{}, pairs, Engine::Auto);
+    }
+
+    /**
+     * @brief Constructs an EnumString from an array of enum-string pairs, visiting the heaviest first.
+     * 
+     * @param pairs The enum values and their corresponding strings.
+     * @param entry_weights The relative lookup frequency of each pair.
+     * @return The EnumString holding the given mappings.
+     */
+    [[nodiscard]] static constexpr EnumString from_pairs(
+        const std::array<std::pair<E, std::string_view>, N>& pairs, const EntryWeights<N>& entry_weights) {
+        return EnumString(FromPairsTag{}, pairs, Engine::Auto, entry_weights);
+    }
+
+    /**
+     * @brief Returns a copy of this table that reports its lookups to another policy.
+     * 
+     * @code
+     * constexpr auto planets = EnumString(...).with_instrumentation<LookupInstrumentation<PlanetsTag>>();
+     * @endcode
+     * 
+     * @tparam Policy The instrumentation policy of the copy.
+     * @return The same mappings with the given policy.
+     */
+    template<typename Policy>
+    [[nodiscard]] constexpr EnumString<E, N, Policy> with_instrumentation() const {
+        if (std::optional<EntryWeights<N>> w = scan_weights()) {
+            return EnumString<E, N, Policy>::from_pairs(to_pairs(), *w).with_engine(selected_engine);
+        }
+        return EnumString<E, N, Policy>::from_pairs(to_pairs()).with_engine(selected_engine);
+    }
+
+    /**
+     * @brief Returns a copy of this table that uses the given lookup engine.
+     * 
+     * @code
+     * constexpr auto planets = EnumString(...).with_engine(Topname::Engine::PerfectHash);
+     * @endcode
+     * 
+     * @param engine The engine of the copy; Engine::Auto lets the cost model choose.
+     * @return The same mappings served by the given engine.
+     * @throw EngineUnavailable If PerfectHash is requested and two strings share a hash.
+     */
+    [[nodiscard]] constexpr EnumString with_engine(Engine engine) const {
+        return EnumString(FromPairsTag{}, to_pairs(), engine, scan_weights());
+    }
+
+    /**
+     * @brief Returns the engine serving string lookups, never Engine::Auto.
+     */
+    [[nodiscard]] constexpr Engine engine() const noexcept {
+        return selected_engine;
+    }
+
+    /**
+     * @brief Predicts the to_enum() cost of every engine for these strings.
+     * 
+     * Inputs are assumed to be drawn uniformly from the mapped strings.
+     * Every engine has a fixed cost per lookup on top of the following.
+     * LinearScan is charged every entry it passes and, in full, every entry
+     * of equal length it compares against. HashProbe is charged hashing,
+     * which includes comparing the string it finds, and its average probe
+     * length; strings sharing a 32-bit hash only lengthen the probe chains.
+     * PerfectHash is charged hashing only, and is ruled out when two
+     * distinct strings share a hash, since it can not give them a slot each.
+     * 
+     * @param model The per-operation costs.
+     * @return The predicted cost of each engine.
+     */
+    [[nodiscard]] constexpr EngineCosts engine_costs(const EngineCostModel& model = DEFAULT_ENGINE_COST_MODEL) const {
+        constexpr double infinity = std::numeric_limits<double>::infinity();
+        EngineCosts costs;
+        if constexpr (N == 0) {
+            return costs;
+        }
+
+        // Finding the k-th of c strings of length L compares k strings of L bytes.
+        std::array<std::size_t, N> lengths{};
+        for (std::size_t i = 0; i < N; i++) {
+            lengths[i] = mappings[i].string_val.size();
+        }
+        std::sort(lengths.begin(), lengths.end());
+        double scanned = static_cast<double>(N) * static_cast<double>(N + 1) / 2.0;
+        double compared = 0.0;
+        for (std::size_t i = 0, count = 1; i < N; i++, count++) {
+            if (i + 1 == N || lengths[i + 1] != lengths[i]) {
+                compared += static_cast<double>(lengths[i]) * static_cast<double>(count * (count + 1) / 2);
+                count = 0;
+            }
+        }
+        costs.linear_scan = model.scan_fixed
+                          + (model.scan_entry * scanned + model.compare_byte * compared) / static_cast<double>(N);
+
+        // Replay the insertions of build_hash_table() to find probe lengths and collisions.
+        std::array<uint32_t, HASH_TABLE_SIZE> slots{};
+        slots.fill(EMPTY_SLOT);
+        double bytes = 0.0, probes = 0.0;
+        bool collision_free = true;
+        for (std::size_t i = 0; i < N; i++) {
+            const uint32_t full = hash(mappings[i].string_val);
+            bytes += static_cast<double>(mappings[i].string_val.size());
+            std::size_t h = full % HASH_TABLE_SIZE;
+            probes += 1.0;
+            while (slots[h] != EMPTY_SLOT && mappings[slots[h]].string_val != mappings[i].string_val) {
+                if (hash(mappings[slots[h]].string_val) == full) {
+                    collision_free = false;
+                }
+                h = (h + 1) % HASH_TABLE_SIZE;
+                probes += 1.0;
+            }
+            if (slots[h] == EMPTY_SLOT) {
+                slots[h] = static_cast<uint32_t>(i);
+            }
+        }
+        double average_bytes = bytes / static_cast<double>(N);
+        costs.hash_probe = model.hash_fixed + model.hash_byte * average_bytes + model.probe * probes / static_cast<double>(N);
+        costs.perfect_hash = model.perfect_fixed + model.hash_byte * average_bytes;
+        if (!collision_free) {
+            costs.perfect_hash = infinity;
+        }
+        return costs;
     }
 
     /**
      * @brief Converts a string to its corresponding enum value.
      * 
-     * Average time complexity: O(1).
+     * Average time complexity: O(1), or O(n) for the small tables served by
+     * Engine::LinearScan.
      * 
      * @param value The string to convert.
      * @return The corresponding enum value.
      * @throw InvalidStringValue If the string does not match any enum value.
      */
     [[nodiscard]] constexpr E to_enum(std::string_view value) const {
-        uint32_t h = hash(value) % HASH_TABLE_SIZE;
-        while (hash_table[h].first != 0) {
-            if (hash_table[h].first == hash(value)) {
-                return hash_table[h].second;
-            }
-            h = (h + 1) % HASH_TABLE_SIZE;
+        typename Instrumentation::Scope scope(LookupOp::ToEnum);
+        if (std::optional<E> found = find_enum(value)) {
+            scope.hit();
+            return *found;
         }
+        scope.miss(value);
         auto err = EnumStringException::ErrorCode::InvalidStringValue;
         throw EnumStringException(err, "String value not found in the mapping");
     }
 
+    /**
+     * @brief Converts a string to its corresponding enum value without throwing.
+     *
+     * Reported to the instrumentation policy as LookupOp::ToEnum.
+     *
+     * @param value The string to convert.
+     * @return The corresponding enum value, or std::nullopt if the string is not mapped.
+     */
+    [[nodiscard]] constexpr std::optional<E> try_to_enum(std::string_view value) const {
+        typename Instrumentation::Scope scope(LookupOp::ToEnum);
+        std::optional<E> found = find_enum(value);
+        if (found) {
+            scope.hit();
+        } else {
+            scope.miss(value);
+        }
+        return found;
+    }
+
+    /**
+     * @brief Converts a quoted token to its enum value without unescaping it into a copy.
+     *
+     * The token starts at p with its opening quote and ends at the closing
+     * quote; whatever follows is left alone. Tokens without escapes, the
+     * common case, are located with a SIMD scan for the closing quote and
+     * looked up in place like to_enum(). Tokens with escapes are decoded
+     * once into the djb2 hash and a 64-byte stack buffer, so no heap copy
+     * is made; a hash match is confirmed by comparing the candidate string
+     * with the buffer, or with the token decoded again if it is longer.
+     * Tokens longer than max_string_length() are rejected without a lookup.
+     *
+     * Reported to the instrumentation policy as LookupOp::ToEnum. A miss
+     * reports the unescaped token without its quotes; escaped tokens longer
+     * than 64 bytes are reported as their first 64 unescaped bytes.
+     *
+     * @param p The opening quote.
+     * @param end The end of the input.
+     * @param style How the token escapes quotes.
+     * @return The enum value and the number of bytes consumed, including both quotes.
+     * @throw ParseError If p is not a quote, the token is not closed, or it has an invalid escape.
+     * @throw InvalidStringValue If the unescaped token does not match any enum value.
+     */
+    [[nodiscard]] constexpr QuotedMatch<E> to_enum_from_quoted(const char* p, const char* end,
+                                                               QuoteStyle style = QuoteStyle::Json) const {
+        typename Instrumentation::Scope scope(LookupOp::ToEnum);
+        const char* after = nullptr;
+        std::array<char, QUOTED_BUFFER> buffer;
+        std::string_view token;
+        std::optional<E> found = find_quoted(p, end, style, after, buffer, token);
+        if (after == nullptr) {
+            auto err = EnumStringException::ErrorCode::ParseError;
+            throw EnumStringException(err, "Malformed quoted string");
+        }
+        auto consumed = static_cast<std::size_t>(after - p);
+        if (!found) {
+            scope.miss(token);
+            auto err = EnumStringException::ErrorCode::InvalidStringValue;
+            throw EnumStringException(err, "String value not found in the mapping");
+        }
+        scope.hit();
+        return {*found, consumed};
+    }
+
+    /**
+     * @brief Converts a quoted token to its enum value without throwing.
+     *
+     * @return The enum value and the bytes consumed, or std::nullopt where to_enum_from_quoted() would throw.
+     */
+    [[nodiscard]] constexpr std::optional<QuotedMatch<E>> try_to_enum_from_quoted(
+        const char* p, const char* end, QuoteStyle style = QuoteStyle::Json) const {
+        typename Instrumentation::Scope scope(LookupOp::ToEnum);
+        const char* after = nullptr;
+        std::array<char, QUOTED_BUFFER> buffer;
+        std::string_view token;
+        std::optional<E> found = find_quoted(p, end, style, after, buffer, token);
+        if (after == nullptr) {
+            return std::nullopt;
+        }
+        auto consumed = static_cast<std::size_t>(after - p);
+        if (!found) {
+            scope.miss(token);
+            return std::nullopt;
+        }
+        scope.hit();
+        return QuotedMatch<E>{*found, consumed};
+    }
+
     /**
      * @brief Converts a string to its corresponding enum value (case-insensitive).
      * 
@@ -167,16 +1183,19 @@ public:
      * @throw InvalidStringValue If the string does not match any enum value.
      */
     [[nodiscard]] constexpr E to_enum_insensitive(std::string_view value) const {
-        auto it = std::ranges::find_if(mappings, [value](const auto& pair) {
+        typename Instrumentation::Scope scope(LookupOp::ToEnumInsensitive);
+        std::size_t i = scan_find([value](const auto& pair) {
             return case_insensitive_equal(pair.string_val, value);
         });
 
-        if (it == mappings.end()) {
+        if (i == N) {
+            scope.miss(value);
             auto err = EnumStringException::ErrorCode::InvalidStringValue;
             throw EnumStringException(err, "String value not found in the mapping");
         }
 
-        return it->enum_val;
+        scope.hit();
+        return mappings[i].enum_val;
     }
 
     /**
@@ -187,14 +1206,42 @@ public:
      * @throw InvalidEnumValue If the enum value does not match any string.
      */
     [[nodiscard]] constexpr std::string_view to_string(E value) const {
-        auto it = std::ranges::find_if(mappings, [value](const auto& pair) {
+        typename Instrumentation::Scope scope(LookupOp::ToString);
+        std::size_t i = scan_find([value](const auto& pair) {
             return pair.enum_val == value; });
 
-        if (it == mappings.end()) {
+        if (i == N) {
             auto err = EnumStringException::ErrorCode::InvalidEnumValue;
             throw EnumStringException(err, "Enum value not found in the mapping");
         }
-        return it->string_val;
+        scope.hit();
+        return mappings[i].string_val;
+    }
+
+    /**
+     * @brief Converts an enum value to its corresponding string without throwing.
+     *
+     * Reported to the instrumentation policy as LookupOp::ToString.
+     *
+     * @param value The enum value to convert.
+     * @return The corresponding string, or std::nullopt if the enum value is not mapped.
+     */
+    [[nodiscard]] constexpr std::optional<std::string_view> try_to_string(E value) const {
+        typename Instrumentation::Scope scope(LookupOp::ToString);
+        std::size_t i = scan_find([value](const auto& pair) {
+            return pair.enum_val == value; });
+        if (i == N) {
+            return std::nullopt;
+        }
+        scope.hit();
+        return mappings[i].string_val;
+    }
+
+    /**
+     * @brief Returns the length of the longest string, e.g. to align columns of names.
+     */
+    [[nodiscard]] constexpr std::size_t max_string_length() const noexcept {
+        return max_length;
     }
 
     /**
@@ -230,13 +1277,11 @@ public:
      * @return True if the enum value exists in the mapping, false otherwise.
      */
     constexpr bool contains(E target) const {
-        bool found = false;
-        for_each_enum([&found, target](E enum_val) {
-            if (enum_val == target) {
-                found = true;
-                return;
-            }
-        });
+        typename Instrumentation::Scope scope(LookupOp::ContainsEnum);
+        bool found = scan_find([target](const auto& pair) { return pair.enum_val == target; }) != N;
+        if (found) {
+            scope.hit();
+        }
         return found;
     }
 
@@ -247,13 +1292,13 @@ public:
      * @return True if the string value exists in the mapping, false otherwise.
      */
     constexpr bool contains(std::string_view target) const {
-        bool found = false;
-        for_each_string([&found, target](std::string_view str_val) {
-            if (str_val == target) {
-                found = true;
-                return;
-            }
-        });
+        typename Instrumentation::Scope scope(LookupOp::ContainsString);
+        bool found = scan_find([target](const auto& pair) { return pair.string_val == target; }) != N;
+        if (found) {
+            scope.hit();
+        } else {
+            scope.miss(target);
+        }
         return found;
     }
 
@@ -297,32 +1342,100 @@ public:
     }
 
     /**
-     * @brief Overloads the '<<' operator for EnumString.
+     * @brief Reports how well the hash table spreads the mapped strings.
      * 
-     * Outputs the string representation of all enum-string pairs.
+     * Hash engines compare the string of every slot whose hash matches, so
+     * hash_collisions only lengthen probe chains; unreachable_entries counts
+     * later aliases of a string, which resolve to its first enum value.
      * 
-     * @tparam F The enum type.
-     * @tparam M The number of mappings.
-     * @param os The output stream.
-     * @param enum_str The EnumString instance.
-     * @return The output stream.
+     * @return The statistics of this table.
      */
-    template<EnumType F, std::size_t M>
-    friend std::ostream& operator<<(std::ostream& os, const EnumString<F, M>& enum_str);
+    [[nodiscard]] constexpr HashTableStats stats() const {
+        HashTableStats res;
+        res.size = N;
+        res.capacity = selected_engine == Engine::LinearScan ? 0 : HASH_TABLE_SIZE;
+        res.engine = engine_name(selected_engine);
+
+        std::size_t total_probes = 0;
+        for (std::size_t i = 0; i < N; i++) {
+            uint32_t full = hash(mappings[i].string_val);
+            std::size_t probes = 1;
+            if (selected_engine == Engine::LinearScan) {
+                // The scan visits scan_order, heaviest first on a weighted table.
+                std::size_t k = 0;
+                while (mappings[scan_order[k]].string_val != mappings[i].string_val) {
+                    k++;
+                    probes++;
+                }
+                if (mappings[scan_order[k]].enum_val != mappings[i].enum_val) {
+                    res.unreachable_entries++;
+                }
+            } else {
+                std::size_t home = selected_engine == Engine::PerfectHash
+                    ? perfect_hash_slot(full, displacements[perfect_hash_bucket(full)])
+                    : full % HASH_TABLE_SIZE;
+                std::size_t h = home;
+                auto holds = [&](const HashSlot& slot) {
+                    return slot.full == full && mappings[slot.index].string_val == mappings[i].string_val;
+                };
+                while (selected_engine == Engine::HashProbe && hash_table[h].index != EMPTY_SLOT &&
+                       !holds(hash_table[h])) {
+                    h = (h + 1) % HASH_TABLE_SIZE;
+                    probes++;
+                }
+                if (hash_table[h].index == EMPTY_SLOT || !holds(hash_table[h]) ||
+                    mappings[hash_table[h].index].enum_val != mappings[i].enum_val) {
+                    res.unreachable_entries++;
+                }
+                if (h != home) {
+                    res.displaced_entries++;
+                }
+            }
+            total_probes += probes;
+            res.max_probe_length = std::max(res.max_probe_length, probes);
+
+            for (std::size_t j = 0; j < i; j++) {
+                if (hash(mappings[j].string_val) == full && mappings[j].string_val != mappings[i].string_val) {
+                    res.hash_collisions++;
+                    break;
+                }
+            }
+        }
+        if constexpr (N > 0) {
+            res.average_probe_length = static_cast<double>(total_probes) / static_cast<double>(N);
+        }
+
+        // Walk the clusters starting after an empty slot so none wraps around the end.
+        std::size_t start = 0;
+        while (start < HASH_TABLE_SIZE && hash_table[start].index != EMPTY_SLOT) {
+            start++;
+        }
+        std::size_t run = 0;
+        for (std::size_t k = 1; k <= HASH_TABLE_SIZE; k++) {
+            if (hash_table[(start + k) % HASH_TABLE_SIZE].index != EMPTY_SLOT) {
+                run++;
+            } else if (run > 0) {
+                res.clusters++;
+                res.largest_cluster = std::max(res.largest_cluster, run);
+                run = 0;
+            }
+        }
+        return res;
+    }
 
     /**
-     * @brief Overloads the '<<' operator for enum values.
+     * @brief Overloads the '<<' operator for EnumString.
      * 
-     * Outputs the string corresponding to the given enum value.
+     * Outputs the string representation of all enum-string pairs.
      * 
      * @tparam F The enum type.
      * @tparam M The number of mappings.
      * @param os The output stream.
-     * @param enum_val The enum value.
+     * @param enum_str The EnumString instance.
      * @return The output stream.
      */
-    template<EnumType F, std::size_t M>
-    friend std::ostream& operator<<(std::ostream& os, F enum_val);
+    template<EnumType F, std::size_t M, typename I>
+    friend std::ostream& operator<<(std::ostream& os, const EnumString<F, M, I>& enum_str);
 
     /**
      * @class Iterator
@@ -412,8 +1525,8 @@ public:
  * @param enum_str The EnumString instance.
  * @return The output stream.
  */
-template<EnumType E, std::size_t N>
-std::ostream& operator<<(std::ostream& os, const EnumString<E, N>& enum_str) {
+template<EnumType E, std::size_t N, typename I>
+std::ostream& operator<<(std::ostream& os, const EnumString<E, N, I>& enum_str) {
     os << "EnumString{";
     for (std::size_t i = 0; i < N; i++) {
         if (i > 0) os << ", ";
@@ -424,6 +1537,28 @@ std::ostream& operator<<(std::ostream& os, const EnumString<E, N>& enum_str) {
     return os;
 }
 
+/**
+ * @brief Checks a table against a probe-length budget, for use in static_assert.
+ * 
+ * @code
+ * static_assert(Topname::within_probe_budget<2>(planet_names), "planet_names probes too long");
+ * @endcode
+ * 
+ * The budget bounds hash probe chains. Tables served by Engine::LinearScan
+ * have none, since the cost model only scans while that is cheaper than
+ * hashing, and are checked for unreachable entries only.
+ * 
+ * @tparam MaxProbeLength The largest acceptable probe length.
+ * @param table The table to check.
+ * @return True if no entry needs more than MaxProbeLength probes and every entry is reachable.
+ */
+template<std::size_t MaxProbeLength, EnumType E, std::size_t N, typename I>
+consteval bool within_probe_budget(const EnumString<E, N, I>& table) {
+    HashTableStats s = table.stats();
+    bool probes_ok = table.engine() == Engine::LinearScan || s.max_probe_length <= MaxProbeLength;
+    return probes_ok && s.unreachable_entries == 0;
+}
+
 /**
  * @brief Deduction guide for the compile to construct an EnumString struct.
  * 
@@ -433,6 +1568,16 @@ std::ostream& operator<<(std::ostream& os, const EnumString<E, N>& enum_str) {
 template<EnumType E, typename... Args>
 EnumString(E, std::string_view, Args...) -> EnumString<E, sizeof...(Args)/2 + 1>;
 
+/**
+ * @brief Deduction guide to construct an EnumString with entry weights.
+ * 
+ * @tparam M The number of weights, which must match the number of mappings.
+ * @tparam E The enum type.
+ * @tparam Args Variadic template arguments.
+ */
+template<std::size_t M, EnumType E, typename... Args>
+EnumString(EntryWeights<M>, E, std::string_view, Args...) -> EnumString<E, sizeof...(Args)/2 + 1>;
+
 }; // namespace Topname
 
 #endif // TOPNAME_H
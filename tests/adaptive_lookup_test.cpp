@@ -0,0 +1,84 @@
+// Checks of AdaptiveEnumString.
+//
+// Two tables of the same type serve interleaved traffic, one mostly unknown
+// strings and one only known strings; each must settle in its own mode and
+// count only its own samples. Results always match EnumString::try_to_enum,
+// including for unknown strings whose hash collides with a mapped one.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude tests/adaptive_lookup_test.cpp -o adaptive_lookup_test
+// Usage: adaptive_lookup_test
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include <Topname/AdaptiveLookup.hpp>
+
+#include "test_common.hpp"
+
+using namespace Topname;
+
+namespace {
+
+enum class K { Long, Ab, Error1, Error2, X };
+
+constexpr auto names = EnumString(K::Long, "KEY_1000_LONGER_NAME", K::Ab, "Ab", K::Error1, "ERROR_1",
+                                  K::Error2, "ERROR_2", K::X, "x");
+
+const std::vector<std::string> hits{"KEY_1000_LONGER_NAME", "Ab", "ERROR_1", "ERROR_2", "x"};
+// "KEY_1000_LONGER_NALf" and "BA" share the djb2 hash of a mapped string.
+const std::vector<std::string> misses{"KEY_1000_LONGER_NALf", "BA", "ERROR_3", "", "y", "unknown_name"};
+
+void tables_adapt_independently(bool noisy_first) {
+    // With strict alternation, a countdown shared by the two tables would expire on the same one every time.
+    AdaptiveEnumString quiet(names);
+    AdaptiveEnumString noisy(names);
+    std::mt19937 rng(39);
+    auto lookup_quiet = [&] {
+        const std::string& hit = hits[rng() % hits.size()];
+        TOPNAME_CHECK(quiet.try_to_enum(hit) == names.try_to_enum(hit));
+    };
+    auto lookup_noisy = [&] {
+        const std::string& str = rng() % 20 == 0 ? hits[rng() % hits.size()] : misses[rng() % misses.size()];
+        TOPNAME_CHECK(noisy.try_to_enum(str) == names.try_to_enum(str));
+    };
+    for (int i = 0; i < 200000; i++) {
+        if (noisy_first) {
+            lookup_noisy();
+            lookup_quiet();
+        } else {
+            lookup_quiet();
+            lookup_noisy();
+        }
+    }
+    TOPNAME_CHECK(quiet.mode() == AdaptiveMode::DirectProbe);
+    TOPNAME_CHECK(noisy.mode() == AdaptiveMode::PrefilterFirst);
+    TOPNAME_CHECK(quiet.stats().miss_rate == 0.0);
+    TOPNAME_CHECK(noisy.stats().miss_rate > 0.8);
+    TOPNAME_CHECK(quiet.stats().switches == 0);
+    TOPNAME_CHECK(noisy.stats().switches == 1);
+}
+
+void switches_back_and_forth() {
+    AdaptiveEnumString table(names);
+    std::mt19937 rng(40);
+    for (int phase = 0; phase < 4; phase++) {
+        bool miss_heavy = phase % 2 == 1;
+        for (int i = 0; i < 100000; i++) {
+            bool miss = miss_heavy && rng() % 20 != 0;
+            const std::string& str = miss ? misses[rng() % misses.size()] : hits[rng() % hits.size()];
+            TOPNAME_CHECK(table.try_to_enum(str) == names.try_to_enum(str));
+        }
+        TOPNAME_CHECK(table.mode() == (miss_heavy ? AdaptiveMode::PrefilterFirst : AdaptiveMode::DirectProbe));
+    }
+    TOPNAME_CHECK(table.stats().switches == 3);
+}
+
+} // namespace
+
+int main() {
+    tables_adapt_independently(false);
+    tables_adapt_independently(true);
+    switches_back_and_forth();
+    return test::finish("adaptive_lookup_test");
+}
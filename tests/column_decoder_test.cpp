@@ -0,0 +1,105 @@
+// Checks of ColumnDecoder.
+//
+// Rows split across chunks are looked up once, when they are complete, so
+// the instrumentation policy sees one lookup per row and no truncated
+// names. Error bits are set for unknown names, including ones whose hash
+// collides with a mapped name, and a '\r' is only dropped from the last
+// field of a row.
+//
+// Build: g++ -std=c++20 -O2 -pthread -Iinclude tests/column_decoder_test.cpp -o column_decoder_test
+// Usage: column_decoder_test
+
+#include <string>
+#include <vector>
+
+#include <Topname/ColumnDecoder.hpp>
+#include <Topname/Instrumentation.hpp>
+
+#include "test_common.hpp"
+
+using namespace Topname;
+
+namespace {
+
+enum class Key { None, Long, Ab, Red };
+
+struct KeysTag {
+    static constexpr std::string_view name = "keys";
+};
+
+using Counters = LookupInstrumentation<KeysTag>;
+using Capture = UnknownValueCapture<KeysTag>;
+
+constexpr auto keys = EnumString(Key::Long, "KEY_1000_LONGER_NAME", Key::Ab, "Ab", Key::Red, "Red")
+                          .with_instrumentation<CombinedInstrumentation<Counters, Capture>>();
+
+uint64_t to_enum_lookups() {
+    return Counters::snapshot().lookups[static_cast<std::size_t>(LookupOp::ToEnum)];
+}
+
+void split_rows_are_looked_up_once() {
+    ColumnDecoder decoder(keys, 1);
+    std::string text;
+    for (int row = 0; row < 100; row++) {
+        text += std::to_string(row) + (row % 10 == 0 ? ",Purple_unknown,x\n" : ",KEY_1000_LONGER_NAME,x\n");
+    }
+    uint64_t before = to_enum_lookups();
+    Capture::drain([](const CapturedMiss&) {});
+
+    // Feed 7 bytes at a time, as a reader with a small buffer would, carrying the unconsumed rest over.
+    std::vector<Key> codes(128);
+    std::vector<uint64_t> errors(2);
+    std::string pending;
+    std::size_t rows = 0;
+    std::size_t failed = 0;
+    for (std::size_t at = 0; at < text.size(); at += 7) {
+        pending += text.substr(at, 7);
+        ColumnBatch batch = decoder.decode(pending, codes, errors, at + 7 >= text.size());
+        for (std::size_t r = 0; r < batch.rows; r++) {
+            bool unknown = (rows + r) % 10 == 0;
+            TOPNAME_CHECK(codes[r] == (unknown ? Key::None : Key::Long));
+            TOPNAME_CHECK(((errors[r / 64] >> (r % 64)) & 1) == (unknown ? 1u : 0u));
+        }
+        rows += batch.rows;
+        failed += batch.errors;
+        pending.erase(0, batch.consumed);
+    }
+    TOPNAME_CHECK(rows == 100);
+    TOPNAME_CHECK(failed == 10);
+    TOPNAME_CHECK(to_enum_lookups() - before == 100);
+
+    std::size_t captured = Capture::drain([](const CapturedMiss& miss) {
+        TOPNAME_CHECK(miss.value == "Purple_unknown");
+    });
+    TOPNAME_CHECK(captured == 10);
+}
+
+void colliding_unknowns_and_carriage_returns() {
+    static_assert(hash("KEY_1000_LONGER_NAME") == hash("KEY_1000_LONGER_NALf"));
+    static_assert(hash("Ab") == hash("BA"));
+    for (Engine engine : {Engine::LinearScan, Engine::HashProbe, Engine::PerfectHash}) {
+        ColumnDecoder decoder(keys.with_engine(engine), 1);
+        std::vector<Key> codes(8);
+        std::vector<uint64_t> errors(1);
+        std::string text = "0,KEY_1000_LONGER_NAME,x\n"
+                           "1,KEY_1000_LONGER_NALf,x\n"
+                           "2,BA\n"
+                           "3,Ab\r\n"
+                           "4,Red\r,x\n"
+                           "5,Red,x\r\n"
+                           "6,Red\r";
+        ColumnBatch batch = decoder.decode(text, codes, errors, true);
+        TOPNAME_CHECK(batch.rows == 7);
+        TOPNAME_CHECK(batch.errors == 3);
+        TOPNAME_CHECK(codes[0] == Key::Long && codes[3] == Key::Ab && codes[5] == Key::Red && codes[6] == Key::Red);
+        TOPNAME_CHECK(errors[0] == 0b0010110);
+    }
+}
+
+} // namespace
+
+int main() {
+    split_rows_are_looked_up_once();
+    colliding_unknowns_and_carriage_returns();
+    return test::finish("column_decoder_test");
+}
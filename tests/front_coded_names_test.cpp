@@ -0,0 +1,71 @@
+// Checks of FrontCodedNames against EnumString.
+//
+// A string declared twice resolves to the first declared value, also when
+// the two copies fall into different blocks.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude tests/front_coded_names_test.cpp -o front_coded_names_test
+// Usage: front_coded_names_test
+
+#include <array>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Topname/FrontCodedNames.hpp>
+
+#include "test_common.hpp"
+
+using namespace Topname;
+
+namespace {
+
+enum class A : uint8_t { A0, A1, A2, A3, A4, A5, A6, A7, A8, A9, A10, A11, A12, A13, A14, A15, A16 };
+
+// Sorted, "zz" takes ranks 15 and 16 and so heads the second block with the later copy.
+constexpr auto across_blocks = EnumString(
+    A::A0, "a0", A::A1, "a1", A::A2, "a2", A::A3, "a3", A::A4, "a4", A::A5, "a5", A::A6, "a6",
+    A::A7, "a7", A::A8, "a8", A::A9, "a9", A::A10, "b0", A::A11, "b1", A::A12, "b2", A::A13, "b3",
+    A::A14, "b4", A::A15, "zz", A::A16, "zz");
+
+void duplicate_across_block_boundary() {
+    FrontCodedNames names(across_blocks);
+    TOPNAME_CHECK(across_blocks.to_enum("zz") == A::A15);
+    TOPNAME_CHECK(names.to_enum("zz") == A::A15);
+    TOPNAME_CHECK(names.to_string(A::A16) == "zz");
+    TOPNAME_CHECK(names.to_enum("b4") == A::A14);
+    TOPNAME_CHECK(!names.contains("z"));
+    TOPNAME_CHECK(!names.contains("zzz"));
+}
+
+enum class Key : uint16_t {};
+
+void runs_of_duplicates() {
+    // 200 mappings over 20 strings: every string has a run of copies that crosses blocks.
+    constexpr std::size_t N = 200;
+    std::vector<std::string> pool;
+    std::mt19937 rng(29);
+    for (std::size_t i = 0; i < 20; i++) {
+        pool.push_back("name_" + std::to_string(rng() % 1000));
+    }
+    std::array<std::pair<Key, std::string_view>, N> pairs;
+    for (std::size_t i = 0; i < N; i++) {
+        pairs[i] = {static_cast<Key>(i), pool[rng() % pool.size()]};
+    }
+    auto table = EnumString<Key, N>::from_pairs(pairs);
+    FrontCodedNames names(table);
+    for (const std::string& str : pool) {
+        TOPNAME_CHECK(names.contains(str) == table.contains(str));
+        if (table.contains(str)) {
+            TOPNAME_CHECK(names.to_enum(str) == table.to_enum(str));
+        }
+    }
+}
+
+} // namespace
+
+int main() {
+    duplicate_across_block_boundary();
+    runs_of_duplicates();
+    return test::finish("front_coded_names_test");
+}
@@ -0,0 +1,82 @@
+// Checks of LookupInstrumentation.
+//
+// The Prometheus export has the same series on every scrape, whether or not
+// any lookup fell into a bucket, and the per-thread blocks of exited threads
+// are reused by new threads instead of piling up.
+//
+// Build: g++ -std=c++20 -O2 -pthread -Iinclude tests/instrumentation_test.cpp -o instrumentation_test
+// Usage: instrumentation_test
+
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <Topname/Instrumentation.hpp>
+
+#include "test_common.hpp"
+
+using namespace Topname;
+
+namespace {
+
+enum class Color { Red, Green, Blue };
+
+struct ColorsTag {
+    static constexpr std::string_view name = "colors";
+};
+
+using Policy = LookupInstrumentation<ColorsTag>;
+
+constexpr auto colors = EnumString(Color::Red, "Red", Color::Green, "Green", Color::Blue, "Blue")
+                            .with_instrumentation<Policy>();
+
+/**
+ * @brief Returns the names and labels of the exported series, without their values.
+ */
+std::vector<std::string> series() {
+    std::ostringstream os;
+    Policy::export_text(os);
+    std::istringstream lines(os.str());
+    std::vector<std::string> names;
+    for (std::string line; std::getline(lines, line);) {
+        names.push_back(line.substr(0, line.rfind(' ')));
+    }
+    return names;
+}
+
+void stable_series() {
+    (void)colors.try_to_enum("Red");
+    std::vector<std::string> first = series();
+    std::size_t buckets = 0;
+    for (const std::string& name : first) {
+        buckets += name.starts_with("topname_lookup_latency_ns_bucket");
+    }
+    TOPNAME_CHECK(buckets == LatencyHistogram::BUCKETS + 1);
+
+    for (int i = 0; i < 1000; i++) {
+        (void)colors.try_to_enum(i % 2 == 0 ? "Blue" : "Purple");
+        (void)colors.contains(Color::Green);
+    }
+    TOPNAME_CHECK(series() == first);
+}
+
+void blocks_are_reused() {
+    (void)colors.try_to_enum("Red");
+    uint64_t before = Policy::snapshot().lookups[static_cast<std::size_t>(LookupOp::ToEnum)];
+    for (int i = 0; i < 200; i++) {
+        std::thread([] { (void)colors.try_to_enum("Green"); }).join();
+    }
+    // The main thread's block and one block handed from each exited thread to the next.
+    TOPNAME_CHECK(Policy::thread_blocks() == 2);
+    uint64_t after = Policy::snapshot().lookups[static_cast<std::size_t>(LookupOp::ToEnum)];
+    TOPNAME_CHECK(after - before == 200);
+}
+
+} // namespace
+
+int main() {
+    stable_series();
+    blocks_are_reused();
+    return test::finish("instrumentation_test");
+}
@@ -0,0 +1,61 @@
+// Checks of NameSerializer on enums whose values span the whole signed range.
+//
+// The dense index and the sorted index both take the offset of a value from
+// the smallest one, which must not overflow the signed underlying type.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude tests/name_serializer_test.cpp -o name_serializer_test
+// Usage: name_serializer_test
+
+#include <climits>
+#include <vector>
+
+#include <Topname/NameSerializer.hpp>
+
+#include "test_common.hpp"
+
+using namespace Topname;
+
+namespace {
+
+enum class Wide : int { Min = INT_MIN, Zero = 0, Max = INT_MAX };
+enum class Narrow : int { MinusTwo = -2, MinusOne = -1, Zero = 0, One = 1 };
+
+constexpr auto wide_names = EnumString(Wide::Min, "min", Wide::Zero, "zero", Wide::Max, "max");
+constexpr auto narrow_names = EnumString(Narrow::MinusTwo, "-2", Narrow::MinusOne, "-1", Narrow::Zero, "0",
+                                         Narrow::One, "1");
+
+template<typename E>
+bool throws_invalid_value(const NameSerializer<E>& names, E value) {
+    try {
+        std::vector<E> values{value};
+        (void)names.to_string(values, ',');
+    } catch (const EnumStringException& e) {
+        return e.error_code() == EnumStringException::ErrorCode::InvalidEnumValue;
+    }
+    return false;
+}
+
+void full_int_range() {
+    NameSerializer names(wide_names);
+    std::vector<Wide> values{Wide::Max, Wide::Min, Wide::Zero, Wide::Max};
+    TOPNAME_CHECK(names.to_string(values, ',') == "max,min,zero,max");
+    TOPNAME_CHECK(names.to_json_fragment(Wide::Min) == "\"min\"");
+    TOPNAME_CHECK(throws_invalid_value(names, Wide{1}));
+}
+
+void dense_range_queried_far_outside() {
+    NameSerializer names(narrow_names);
+    std::vector<Narrow> values{Narrow::One, Narrow::MinusTwo, Narrow::Zero};
+    TOPNAME_CHECK(names.to_string(values, '|') == "1|-2|0");
+    TOPNAME_CHECK(throws_invalid_value(names, Narrow{INT_MAX}));
+    TOPNAME_CHECK(throws_invalid_value(names, Narrow{INT_MIN}));
+    TOPNAME_CHECK(throws_invalid_value(names, Narrow{2}));
+}
+
+} // namespace
+
+int main() {
+    full_int_range();
+    dense_range_queried_far_outside();
+    return test::finish("name_serializer_test");
+}
@@ -0,0 +1,52 @@
+// Checks of EnumString::stats().
+//
+// On a weighted table served by Engine::LinearScan, probe lengths follow the
+// scan order set by EntryWeights rather than the declaration order.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude tests/table_stats_test.cpp -o table_stats_test
+// Usage: table_stats_test
+
+#include <Topname/Topname.hpp>
+
+#include "test_common.hpp"
+
+using namespace Topname;
+
+namespace {
+
+enum class Level { Debug, Info, Notice, Verbose, Error };
+
+// "b" is declared three times and resolves to Info; the weights move Error, declared last, to the front.
+constexpr auto unweighted = EnumString(Level::Debug, "a", Level::Info, "b", Level::Notice, "b",
+                                       Level::Verbose, "b", Level::Error, "c").with_engine(Engine::LinearScan);
+constexpr auto weighted = EnumString(EntryWeights(1, 1, 1, 1, 100), Level::Debug, "a", Level::Info, "b",
+                                     Level::Notice, "b", Level::Verbose, "b", Level::Error, "c")
+                              .with_engine(Engine::LinearScan);
+
+// Scan order a, b, b, b, c: probes 1, 2, 2, 2, 5.
+constexpr HashTableStats unweighted_stats = unweighted.stats();
+static_assert(unweighted_stats.max_probe_length == 5);
+static_assert(unweighted_stats.average_probe_length == 12.0 / 5);
+static_assert(unweighted_stats.unreachable_entries == 2);
+
+// Scan order c, a, b, b, b: probes 1, 2, 3, 3, 3.
+constexpr HashTableStats weighted_stats = weighted.stats();
+static_assert(weighted_stats.max_probe_length == 3);
+static_assert(weighted_stats.average_probe_length == 12.0 / 5);
+static_assert(weighted_stats.unreachable_entries == 2);
+
+void weights_reorder_linear_scan() {
+    TOPNAME_CHECK(weighted.engine() == Engine::LinearScan);
+    TOPNAME_CHECK(weighted.to_enum("b") == Level::Info);
+    TOPNAME_CHECK(weighted.to_enum("c") == Level::Error);
+    HashTableStats stats = weighted.stats();
+    TOPNAME_CHECK(stats.max_probe_length == 3);
+    TOPNAME_CHECK(stats.unreachable_entries == 2);
+}
+
+} // namespace
+
+int main() {
+    weights_reorder_linear_scan();
+    return test::finish("table_stats_test");
+}
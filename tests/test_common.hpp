@@ -0,0 +1,36 @@
+#ifndef TOPNAME_TEST_COMMON_H
+#define TOPNAME_TEST_COMMON_H
+
+#include <cstdio>
+
+namespace Topname::test {
+
+inline int g_failures = 0;
+
+/**
+ * @brief Records a failed check with its location; unlike assert(), it stays active under NDEBUG.
+ */
+inline void check(bool condition, const char* text, const char* file, int line) {
+    if (!condition) {
+        std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, text);
+        g_failures++;
+    }
+}
+
+/**
+ * @brief Reports the outcome of a test program, for its exit status.
+ */
+inline int finish(const char* name) {
+    if (g_failures != 0) {
+        std::fprintf(stderr, "%s: %d check(s) failed\n", name, g_failures);
+        return 1;
+    }
+    std::printf("%s: ok\n", name);
+    return 0;
+}
+
+} // namespace Topname::test
+
+#define TOPNAME_CHECK(condition) ::Topname::test::check((condition), #condition, __FILE__, __LINE__)
+
+#endif // TOPNAME_TEST_COMMON_H
@@ -0,0 +1,133 @@
+// Turns a recorded trace of looked up strings into EntryWeights for an EnumString.
+//
+// The names file lists the strings of the table, one per line, in declaration
+// order (e.g. printed with for_each_string()). The trace holds one looked up
+// string per line, e.g. extracted from request logs; it is read from standard
+// input when no file is given. Each name's weight is the number of trace lines
+// equal to it, compared case-insensitively with --insensitive.
+//
+// Prints the weights as an EntryWeights initializer to pass as the first
+// constructor argument, and to standard error how much of the trace the
+// table covers and how concentrated it is.
+//
+// Build: g++ -std=c++20 -O2 -Iinclude tools/trace_weights.cpp -o trace_weights
+// Usage: trace_weights [--insensitive] names.txt [trace.txt]
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+std::string fold(std::string str) {
+    for (char& ch : str) {
+        ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+    }
+    return str;
+}
+
+std::vector<std::string> read_lines(std::istream& in) {
+    std::vector<std::string> lines;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        lines.push_back(std::move(line));
+    }
+    return lines;
+}
+
+int usage() {
+    std::fprintf(stderr, "usage: trace_weights [--insensitive] names.txt [trace.txt]\n");
+    return 2;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    bool insensitive = false;
+    std::vector<const char*> files;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--insensitive") == 0) {
+            insensitive = true;
+        } else {
+            files.push_back(argv[i]);
+        }
+    }
+    if (files.empty() || files.size() > 2) {
+        return usage();
+    }
+
+    std::ifstream names_file(files[0]);
+    if (!names_file) {
+        std::fprintf(stderr, "trace_weights: can not open %s\n", files[0]);
+        return 1;
+    }
+    std::vector<std::string> names = read_lines(names_file);
+
+    // Duplicate names keep their first index, like the lookups of EnumString.
+    std::unordered_map<std::string, std::size_t> index;
+    for (std::size_t i = 0; i < names.size(); i++) {
+        index.emplace(insensitive ? fold(names[i]) : names[i], i);
+    }
+
+    std::vector<uint64_t> weights(names.size(), 0);
+    uint64_t total = 0, unknown = 0;
+    auto count = [&](std::istream& in) {
+        std::string line;
+        while (std::getline(in, line)) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+            total++;
+            auto it = index.find(insensitive ? fold(line) : line);
+            if (it == index.end()) {
+                unknown++;
+            } else {
+                weights[it->second]++;
+            }
+        }
+    };
+    if (files.size() == 2) {
+        std::ifstream trace(files[1]);
+        if (!trace) {
+            std::fprintf(stderr, "trace_weights: can not open %s\n", files[1]);
+            return 1;
+        }
+        count(trace);
+    } else {
+        count(std::cin);
+    }
+
+    std::printf("Topname::EntryWeights(");
+    for (std::size_t i = 0; i < weights.size(); i++) {
+        std::printf(i == 0 ? "%llu" : ", %llu", static_cast<unsigned long long>(weights[i]));
+    }
+    std::printf(")\n");
+
+    std::vector<uint64_t> sorted = weights;
+    std::sort(sorted.begin(), sorted.end(), std::greater<>());
+    uint64_t known = total - unknown;
+    auto top_share = [&](std::size_t k) {
+        uint64_t sum = 0;
+        for (std::size_t i = 0; i < std::min(k, sorted.size()); i++) {
+            sum += sorted[i];
+        }
+        return known == 0 ? 0.0 : 100.0 * static_cast<double>(sum) / static_cast<double>(known);
+    };
+    std::size_t unused = static_cast<std::size_t>(std::count(weights.begin(), weights.end(), 0));
+    std::fprintf(stderr, "%llu lookups, %llu not in the table, %zu of %zu names never looked up\n",
+                 static_cast<unsigned long long>(total), static_cast<unsigned long long>(unknown),
+                 unused, names.size());
+    std::fprintf(stderr, "top 1 / 4 / 16 names: %.1f%% / %.1f%% / %.1f%% of the hits\n",
+                 top_share(1), top_share(4), top_share(16));
+    return 0;
+}